@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include "uinteger_t.hh"
+
+class counting_resource : public uinteger_t::memory_resource {
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		++allocations;
+		return uinteger_t::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+		++deallocations;
+		uinteger_t::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const uinteger_t::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	std::size_t allocations = 0;
+	std::size_t deallocations = 0;
+};
+
+static uinteger_t big_number(std::size_t digits, uinteger_t::digit seed) {
+	uinteger_t result;
+	for (std::size_t i = 0; i < digits; ++i) {
+		result = (result << 64) | (seed * (i + 1) + 0x9e3779b97f4a7c15ULL);
+	}
+	return result;
+}
+
+TEST(Allocator, default_resource) {
+	const auto a = big_number(80, 0x0123456789abcdefULL);
+	const auto b = big_number(60, 0xfedcba9876543210ULL);
+	const auto product = a * b;
+	const auto quotient = product / b;
+
+	counting_resource counter;
+	{
+		uinteger_t::default_resource_guard guard(&counter);
+		EXPECT_EQ(uinteger_t::get_default_resource(), &counter);
+
+		uinteger_t c = a * b;
+		EXPECT_EQ(c.get_resource(), &counter);
+		EXPECT_EQ(c, product);
+		EXPECT_EQ(c / b, quotient);
+		EXPECT_EQ(uinteger_t(c.str(), 10), product);
+	}
+	EXPECT_EQ(uinteger_t::get_default_resource(), uinteger_t::new_delete_resource());
+	EXPECT_GT(counter.allocations, 0u);
+	EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(Allocator, explicit_resource) {
+	const auto a = big_number(20, 0x0123456789abcdefULL);
+
+	counting_resource counter;
+	{
+		uinteger_t value(&counter);
+		value = a;
+		EXPECT_EQ(value.get_resource(), &counter);
+		EXPECT_EQ(value, a);
+
+		uinteger_t moved = std::move(value);
+		EXPECT_EQ(moved.get_resource(), &counter);
+		EXPECT_EQ(moved, a);
+
+		uinteger_t copied(moved, uinteger_t::new_delete_resource());
+		EXPECT_EQ(copied.get_resource(), uinteger_t::new_delete_resource());
+		EXPECT_EQ(copied, a);
+	}
+	EXPECT_EQ(counter.allocations, 1u);
+	EXPECT_EQ(counter.deallocations, 1u);
+}
+
+TEST(Allocator, monotonic) {
+	const auto a = big_number(50, 0x0123456789abcdefULL);
+	const auto b = big_number(30, 0xfedcba9876543210ULL);
+	const auto expected = (a * b + a) % b;
+
+	uinteger_t::monotonic_buffer_resource arena;
+	uinteger_t result;
+	{
+		uinteger_t::default_resource_guard guard(&arena);
+		auto tmp = (a * b + a) % b;
+		EXPECT_EQ(tmp.get_resource(), &arena);
+		result = std::move(tmp);  // copied out of the arena
+	}
+	arena.release();
+	EXPECT_EQ(result.get_resource(), uinteger_t::new_delete_resource());
+	EXPECT_EQ(result, expected);
+}
+
+TEST(Allocator, monotonic_buffer) {
+	// released arenas start over from the caller's buffer
+	const auto a = big_number(8, 0x0123456789abcdefULL);
+	const auto b = big_number(6, 0xfedcba9876543210ULL);
+	const auto expected = a * b;
+
+	alignas(std::max_align_t) char buffer[4096];
+	counting_resource counter;
+	uinteger_t::monotonic_buffer_resource arena(buffer, sizeof(buffer), &counter);
+	for (int i = 0; i < 3; ++i) {
+		{
+			uinteger_t product(&arena);
+			product = a * b;
+			EXPECT_EQ(product, expected);
+			auto p = reinterpret_cast<const char*>(product.data());
+			EXPECT_TRUE(p >= buffer && p < buffer + sizeof(buffer));
+		}
+		arena.release();
+	}
+	EXPECT_EQ(counter.allocations, 0u);
+
+	// allocations past the buffer come from upstream and are given back
+	void* p = arena.allocate(2 * sizeof(buffer));
+	EXPECT_NE(p, nullptr);
+	EXPECT_EQ(counter.allocations, 1u);
+	arena.release();
+	EXPECT_EQ(counter.deallocations, 1u);
+	EXPECT_EQ(arena.allocate(64), static_cast<void*>(buffer));
+}
+
+TEST(Allocator, karatsuba_scratch) {
+	// Karatsuba recursion runs in a single scratch buffer
+	const auto a = big_number(200, 0x0123456789abcdefULL);
+	const auto b = big_number(150, 0xfedcba9876543210ULL);
+	const auto expected = a * b;
+	const auto expected_sqr = a * uinteger_t(a);
+
+	counting_resource counter;
+	{
+		uinteger_t::default_resource_guard guard(&counter);
+		auto product = a * b;
+		EXPECT_EQ(product, expected);
+		EXPECT_LE(counter.allocations, 2u);
+
+		counter.allocations = 0;
+		auto square = a.sqr();
+		EXPECT_EQ(square, expected_sqr);
+		EXPECT_LE(counter.allocations, 2u);
+	}
+}
+
+TEST(Allocator, increment) {
+	// counters are incremented and decremented in place
+	const uinteger_t one = 1;
+	const auto top = one << 640;
+	const auto start = top - 3;
+	auto value = start;
+
+	counting_resource counter;
+	{
+		uinteger_t::default_resource_guard guard(&counter);
+		for (int i = 0; i < 2; ++i) {
+			++value;
+		}
+		EXPECT_EQ(counter.allocations, 0u);
+		EXPECT_EQ(value + 1, top);
+
+		++value;  // carried out of the top digit
+		EXPECT_EQ(value, top);
+		--value;
+		EXPECT_EQ(value + 1, top);
+		for (int i = 0; i < 2; ++i) {
+			value--;
+		}
+		EXPECT_EQ(value, start);
+	}
+
+	uinteger_t zero;
+	--zero;  // wraps around
+	EXPECT_EQ(zero, 0xffffffffffffffffULL);
+	++zero;
+	EXPECT_EQ(zero, one << 64);
+}
+
+TEST(Allocator, rvalue_operands) {
+	// expiring operands lend their storage to the result
+	const auto a = big_number(40, 0x0123456789abcdefULL);
+	const auto b = big_number(40, 0xfedcba9876543210ULL);
+	const auto c = big_number(30, 0x0f1e2d3c4b5a6978ULL);
+	const auto expected = a + b;
+	const auto expected_sum = expected + c;
+	const auto expected_xor = expected ^ c;
+	const auto expected_diff = expected - c;
+
+	counting_resource counter;
+	{
+		uinteger_t::default_resource_guard guard(&counter);
+		EXPECT_EQ((a + b) + c, expected_sum);
+		EXPECT_EQ(counter.allocations, 1u);
+
+		counter.allocations = 0;
+		EXPECT_EQ(c ^ (a + b), expected_xor);
+		EXPECT_EQ((a + b) - c, expected_diff);
+		EXPECT_EQ(((a + b) << 64) >> 64, expected);  // the shift grows once
+		EXPECT_EQ(counter.allocations, 4u);
+
+		uinteger_t value = expected_sum;
+		counter.allocations = 0;
+		value = expected;  // copy assignment reuses the capacity
+		EXPECT_EQ(value, expected);
+		value = c;
+		EXPECT_EQ(value, c);
+		EXPECT_EQ(counter.allocations, 0u);
+	}
+}
+
+TEST(Allocator, lazy_products) {
+	// every lazy product is accumulated straight into the destination
+	const auto a = big_number(10, 0x0123456789abcdefULL);
+	const auto b = big_number(8, 0xfedcba9876543210ULL);
+	const auto c = big_number(9, 0x0f1e2d3c4b5a6978ULL);
+	const auto d = big_number(7, 0x8796a5b4c3d2e1f0ULL);
+	const uinteger_t e = 12345;
+	const auto expected = a * b + c * d - e;
+	const auto expected_sum = expected + a * b + c * d;
+	const auto L = [](const uinteger_t& num) { return uinteger_t::lazy(num); };
+
+	uinteger_t r = expected << 256;  // room for the result
+
+	counting_resource counter;
+	{
+		uinteger_t::default_resource_guard guard(&counter);
+		r = L(a) * b + L(c) * d - e;
+		EXPECT_EQ(r, expected);
+		r += L(a) * b + L(c) * d;
+		EXPECT_EQ(r, expected_sum);
+	}
+	EXPECT_EQ(counter.allocations, 0u);
+}
@@ -31,3 +31,30 @@ TEST(Assignment, all) {
 	EXPECT_EQ(u32_1, u32_2);
 	EXPECT_EQ(u64_1, u64_2);
 }
+
+TEST(Assignment, storage) {
+	// values crossing the inline storage boundary must survive copies and moves
+	uinteger_t small(0x0123456789abcdefULL);
+	uinteger_t big = small;
+	for (std::size_t i = 0; i < uinteger_t::inline_digits * 2; ++i) {
+		big = (big << 64) | small;
+	}
+	EXPECT_EQ(big.bits(), 57 + 64 * uinteger_t::inline_digits * 2);
+
+	uinteger_t big_copy = big;
+	uinteger_t small_copy = small;
+	EXPECT_EQ(big_copy, big);
+	EXPECT_EQ(small_copy, small);
+
+	uinteger_t moved_big = std::move(big_copy);
+	uinteger_t moved_small = std::move(small_copy);
+	EXPECT_EQ(moved_big, big);
+	EXPECT_EQ(moved_small, small);
+
+	moved_small = std::move(moved_big);
+	moved_big = small;
+	EXPECT_EQ(moved_small, big);
+	EXPECT_EQ(moved_big, small);
+
+	EXPECT_EQ(big >> (64 * uinteger_t::inline_digits * 2), small);
+}
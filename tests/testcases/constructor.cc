@@ -74,6 +74,49 @@ TEST(Constructor, string) {
 	EXPECT_EQ(uinteger_t(uuid2, 256).str(), "287473478535710989927820548052301802926");
 }
 
+TEST(Constructor, string_large) {
+	EXPECT_EQ(uinteger_t("18446744073709551616", 10), uinteger_t(1) << 64);
+	EXPECT_EQ(uinteger_t("0000000000000000000000000018446744073709551615", 10), 0xffffffffffffffffULL);
+	EXPECT_EQ(uinteger_t("3W5E11264SGSF", 36), 0xffffffffffffffffULL);
+	EXPECT_EQ(uinteger_t("", 10), 0);
+	EXPECT_THROW(uinteger_t("12345678x", 10), std::invalid_argument);
+	EXPECT_THROW(uinteger_t("123456789012345678901234567890a", 10), std::invalid_argument);
+	EXPECT_THROW(uinteger_t("129", 9), std::invalid_argument);
+
+	// large enough to be split by powers of the base
+	for (std::size_t length : {19, 20, 100, 1000, 10000, 50000}) {
+		uinteger_t power = 1;
+		for (std::size_t i = 0; i < length; ++i) {
+			power *= 10;
+		}
+		EXPECT_EQ(uinteger_t("1" + std::string(length, '0'), 10), power);
+		EXPECT_EQ(uinteger_t(std::string(length, '9'), 10), power - 1);
+		EXPECT_EQ(uinteger_t(std::string(length, '0') + "7", 10), 7);
+	}
+	const auto num = (uinteger_t(1) << 100000) / 7 + 12345;
+	for (int base : {3, 10, 36}) {
+		EXPECT_EQ(uinteger_t(num.str(base), base), num);
+	}
+}
+
+TEST(Constructor, string_power_of_two) {
+	EXPECT_EQ(uinteger_t("0123456789abcdefFEDCBA9876543210", 16), uinteger_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL));
+	EXPECT_EQ(uinteger_t("10000000000000000", 16), uinteger_t(1) << 64);
+	EXPECT_EQ(uinteger_t("1" + std::string(64, '0'), 2), uinteger_t(1) << 64);
+	EXPECT_EQ(uinteger_t("2000000000000000000000", 8), uinteger_t(1) << 64);
+	EXPECT_EQ(uinteger_t("g000000000000", 32), uinteger_t(1) << 64);
+	EXPECT_EQ(uinteger_t("", 16), 0);
+	EXPECT_THROW(uinteger_t("0123456789abcdefg123456789abcdef", 16), std::invalid_argument);
+	EXPECT_THROW(uinteger_t("0123456789abcdef0123456789abcdeg", 16), std::invalid_argument);
+	EXPECT_THROW(uinteger_t("0128", 8), std::invalid_argument);
+
+	const auto num = (uinteger_t(1) << 10000) / 7 + 12345;
+	for (int base : {2, 4, 8, 16, 32}) {
+		EXPECT_EQ(uinteger_t(num.str(base), base), num);
+		EXPECT_EQ(uinteger_t("000" + num.str(base), base), num);
+	}
+}
+
 TEST(Constructor, big) {
 	std::random_device engine;
 	std::vector<char> data(1000000);
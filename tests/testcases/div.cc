@@ -39,3 +39,106 @@ TEST(External, divide) {
 	EXPECT_EQ(u32 /= val, (uint32_t) 0x163356bULL);
 	EXPECT_EQ(u64 /= val, (uint64_t) 0x163356b88ac0de0ULL);
 }
+
+static uinteger_t pseudo_random(std::size_t digits, std::uint64_t seed) {
+	uinteger_t result;
+	for (std::size_t i = 0; i < digits; ++i) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		result = (result << 64) | seed;
+	}
+	return result;
+}
+
+TEST(Arithmetic, divide_large) {
+	// divisors below and above the Burnikel-Ziegler cutoff, dividends built
+	// as quotient * divisor + remainder
+	const uinteger_t one = 1;
+	for (const auto& sizes : std::vector<std::pair<std::size_t, std::size_t>>{{3, 5}, {20, 40}, {60, 150}, {100, 100}, {150, 300}, {300, 200}, {700, 1000}}) {
+		std::vector<uinteger_t> divisors{
+			pseudo_random(sizes.first, sizes.first),
+			(one << (sizes.first * 64 - 1)),                    // power of two
+			(one << (sizes.first * 64)) - 1,                    // all ones
+			(one << (sizes.first * 64 - 64)) + pseudo_random(1, 3),  // sparse
+		};
+		for (const auto& divisor : divisors) {
+			const auto quotient = pseudo_random(sizes.second, sizes.second);
+			const auto remainder = divisor - pseudo_random(1, 7);
+			const auto dividend = quotient * divisor + remainder;
+			EXPECT_EQ(dividend / divisor, quotient);
+			EXPECT_EQ(dividend % divisor, remainder);
+
+			const auto power = one << (quotient.bits() + divisor.bits());
+			EXPECT_EQ(power / divisor * divisor + power % divisor, power);
+			EXPECT_LT(power % divisor, divisor);
+		}
+	}
+}
+
+TEST(Arithmetic, divisor) {
+	// precomputed divisors give the same results as plain division
+	const uinteger_t one = 1;
+	std::vector<uinteger_t> divisors{
+		7,
+		0xffffffffffffffffULL,
+		one << 63,
+		pseudo_random(2, 2),
+		(one << 128) - 1,
+		pseudo_random(5, 5),
+		(one << 640) + 1,
+		pseudo_random(120, 120),
+	};
+	for (const auto& value : divisors) {
+		const uinteger_t::divisor divisor(value);
+		EXPECT_EQ(divisor.value(), value);
+		for (std::size_t digits : {1, 2, 3, 6, 20, 130, 300}) {
+			const auto num = pseudo_random(digits, digits + value.bits());
+			EXPECT_EQ(num / divisor, num / value);
+			EXPECT_EQ(num % divisor, num % value);
+			auto q = num;
+			q /= divisor;
+			auto r = num;
+			r %= divisor;
+			EXPECT_EQ(q * value + r, num);
+		}
+	}
+	EXPECT_THROW(uinteger_t::divisor(0), std::domain_error);
+}
+
+TEST(Arithmetic, divide_newton) {
+	// Newton division only runs for huge operands, so it is checked here with
+	// small cutoffs against plain division
+	std::uint64_t seed = 1;
+	for (std::size_t cutoff = 1; cutoff <= 5; ++cutoff) {
+		for (std::size_t rhs_digits = 1; rhs_digits <= 40; rhs_digits += 3) {
+			for (std::size_t extra : {0, 1, 2, 7, 40, 95}) {
+				const auto lhs = pseudo_random(rhs_digits + extra, ++seed);
+				++seed;
+				const auto rhs = pseudo_random(rhs_digits, seed) >> (seed % 64);
+				if (!rhs) {
+					continue;
+				}
+				uinteger_t q, r, expected_q, expected_r;
+				uinteger_t::newton_divmod(q, r, lhs, rhs, cutoff);
+				uinteger_t::divmod(expected_q, expected_r, lhs, rhs);
+				EXPECT_EQ(q, expected_q);
+				EXPECT_EQ(r, expected_r);
+			}
+		}
+	}
+
+	// the reciprocal of a normalized n digit number is within a few units of
+	// floor(BASE^(2 n) / d)
+	const uinteger_t one = 1;
+	for (std::size_t cutoff = 1; cutoff <= 5; ++cutoff) {
+		for (std::size_t digits = 1; digits <= 60; digits += 7) {
+			const auto top = one << (digits * uinteger_t::digit_bits - 1);
+			for (const auto& d : {top | pseudo_random(digits, ++seed), top, (top << 1) - 1}) {
+				uinteger_t reciprocal;
+				uinteger_t::newton_reciprocal(reciprocal, d, cutoff);
+				const auto exact = (one << (2 * digits * uinteger_t::digit_bits)) / d;
+				const auto error = reciprocal > exact ? reciprocal - exact : exact - reciprocal;
+				EXPECT_LE(error, 4);
+			}
+		}
+	}
+}
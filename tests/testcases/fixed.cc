@@ -0,0 +1,71 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "uinteger_t.hh"
+
+// the fixed width aliases leave room for a user's own uint128_t
+typedef std::pair<std::uint64_t, std::uint64_t> uint128_t;
+
+template <typename Fixed>
+static void check_random_ops(std::mt19937_64& gen) {
+	const auto modulus = uinteger_t(1) << Fixed::digits * 64;
+	for (int n = 0; n < 200; ++n) {
+		uinteger_t a, b;
+		auto a_digits = gen() % Fixed::digits + 1;
+		auto b_digits = gen() % Fixed::digits + 1;
+		for (std::size_t i = 0; i < a_digits; ++i) a = (a << 64) | gen();
+		for (std::size_t i = 0; i < b_digits; ++i) b = (b << 64) | gen();
+		if (!b) b = 1;
+		const Fixed fa(a), fb(b);
+		auto shift = static_cast<std::size_t>(gen() % (Fixed::digits * 64 + 10));
+
+		EXPECT_EQ((fa + fb).to_uinteger(), (a + b) % modulus);
+		EXPECT_EQ((fa - fb).to_uinteger(), (a + modulus - b) % modulus);
+		EXPECT_EQ((fa * fb).to_uinteger(), (a * b) % modulus);
+		EXPECT_EQ((fa / fb).to_uinteger(), a / b);
+		EXPECT_EQ((fa % fb).to_uinteger(), a % b);
+		EXPECT_EQ((fa & fb).to_uinteger(), a & b);
+		EXPECT_EQ((fa | fb).to_uinteger(), a | b);
+		EXPECT_EQ((fa ^ fb).to_uinteger(), a ^ b);
+		EXPECT_EQ((fa << shift).to_uinteger(), (a << shift) % modulus);
+		EXPECT_EQ((fa >> shift).to_uinteger(), a >> shift);
+		EXPECT_EQ(fa < fb, a < b);
+		EXPECT_EQ(fa == fb, a == b);
+		EXPECT_EQ(fa.bits(), a.bits());
+		EXPECT_EQ(fa.str(), a.str());
+	}
+}
+
+TEST(Fixed, arithmetic) {
+	std::mt19937_64 gen(0x5eed);
+	check_random_ops<uinteger128_t>(gen);
+	check_random_ops<uinteger256_t>(gen);
+	check_random_ops<uinteger512_t>(gen);
+	check_random_ops<uinteger1024_t>(gen);
+}
+
+TEST(Fixed, wrap_around) {
+	const uinteger256_t max = -1;
+	EXPECT_EQ(max.bits(), 256u);
+	EXPECT_EQ(max + 1, 0);
+	EXPECT_EQ(uinteger256_t(0) - 1, max);
+	EXPECT_EQ(-uinteger256_t(1), max);
+
+	uinteger128_t counter = 0xffffffffffffffffULL;
+	EXPECT_EQ(++counter, uinteger128_t(uinteger_t(1) << 64));
+	EXPECT_EQ(--counter, 0xffffffffffffffffULL);
+
+	EXPECT_THROW(uinteger512_t(1) / uinteger512_t(0), std::domain_error);
+}
+
+TEST(Fixed, conversion) {
+	const uinteger_t big("123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0fedcba", 16);
+	EXPECT_EQ(uinteger256_t(big).to_uinteger(), big & ((uinteger_t(1) << 256) - 1));
+	EXPECT_EQ(uinteger512_t(big).to_uinteger(), big);
+	EXPECT_EQ(uinteger512_t(uinteger256_t(big)), uinteger512_t(uinteger256_t(big).to_uinteger()));
+	EXPECT_EQ(uinteger128_t("340282366920938463463374607431768211455"), -uinteger128_t(1));
+	EXPECT_EQ(uinteger128_t(0x0123456789abcdefULL).hex(), "123456789abcdef");
+	EXPECT_EQ(static_cast<unsigned>(uinteger128_t(0x0123456789abcdefULL)), 0x89abcdefU);
+	EXPECT_TRUE(static_cast<bool>(uinteger128_t(uinteger_t(1) << 100)));
+}
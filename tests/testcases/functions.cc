@@ -35,6 +35,71 @@ TEST(Function, str) {
 	}
 }
 
+TEST(Function, str_large) {
+	// large enough to be split by powers of the base
+	for (std::size_t zeros : {1, 19, 20, 100, 1000, 5000, 20000}) {
+		uinteger_t power = 1;
+		for (std::size_t i = 0; i < zeros; ++i) {
+			power *= 10;
+		}
+		EXPECT_EQ(power.str(), "1" + std::string(zeros, '0'));
+		EXPECT_EQ((power - 1).str(), std::string(zeros, '9'));
+		EXPECT_EQ((power + 1).str(), "1" + std::string(zeros - 1, '0') + "1");
+	}
+
+	const uinteger_t one = 1;
+	EXPECT_EQ((one << 64).str(), "18446744073709551616");
+	EXPECT_EQ(((one << 64) - 1).str(36), "3w5e11264sgsf");
+	for (std::size_t bits : {100, 3000, 30000}) {
+		const auto num = (one << bits) / 7 + (one << (bits / 3));
+		for (int base : {3, 7, 10, 36}) {
+			EXPECT_EQ(uinteger_t(num.str(base), base), num);
+		}
+	}
+}
+
+TEST(Function, to_chars) {
+	const uinteger_t original(2216002924);
+	char buffer[64];
+	for (std::pair <uint32_t const, std::string>  t : tests) {
+		EXPECT_GE(original.chars_needed(t.first), t.second.size());
+		EXPECT_LE(original.chars_needed(t.first), t.second.size() + 1);
+		auto r = to_chars(buffer, buffer + t.second.size(), original, t.first);
+		EXPECT_EQ(r.ec, std::errc());
+		EXPECT_EQ(std::string(buffer, r.ptr), t.second);
+		r = to_chars(buffer, buffer + t.second.size() - 1, original, t.first);
+		EXPECT_EQ(r.ec, std::errc::value_too_large);
+
+		uinteger_t value;
+		auto f = from_chars(t.second.data(), t.second.data() + t.second.size(), value, t.first);
+		EXPECT_EQ(f.ec, std::errc());
+		EXPECT_EQ(f.ptr, t.second.data() + t.second.size());
+		EXPECT_EQ(value, original);
+	}
+	EXPECT_EQ(original.chars_needed(16), 8);
+	EXPECT_EQ(uinteger_t(0).chars_needed(10), 1);
+	auto r = to_chars(buffer, buffer + 1, uinteger_t(0));
+	EXPECT_EQ(std::string(buffer, r.ptr), "0");
+
+	// a large number, into a buffer sized by chars_needed()
+	const auto num = (uinteger_t(1) << 30000) / 7 + 12345;
+	std::vector<char> large(num.chars_needed());
+	r = to_chars(large.data(), large.data() + large.size(), num);
+	EXPECT_EQ(std::string(large.data(), r.ptr), num.str());
+
+	// parsing stops at the first character that isn't a digit
+	const std::string text = "12345678901234567890123 rest";
+	uinteger_t value = 7;
+	auto f = from_chars(text.data(), text.data() + text.size(), value);
+	EXPECT_EQ(f.ec, std::errc());
+	EXPECT_EQ(f.ptr, text.data() + 23);
+	EXPECT_EQ(value, uinteger_t("12345678901234567890123"));
+	f = from_chars(text.data() + 23, text.data() + text.size(), value);
+	EXPECT_EQ(f.ec, std::errc::invalid_argument);
+	EXPECT_EQ(f.ptr, text.data() + 23);
+	EXPECT_EQ(value, uinteger_t("12345678901234567890123"));
+}
+
 TEST(External, ostream) {
 	const uinteger_t value(0xfedcba9876543210ULL);
 
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "uinteger_t.hh"
+
+TEST(Lazy, expressions) {
+	// lazy expressions give the same results as the eager operators
+	const uinteger_t a("123456789abcdef0fedcba9876543210deadbeefcafebabe0123456789", 16);
+	const uinteger_t b("fedcba98765432100123456789abcdef", 16);
+	const uinteger_t c = a * 3 + 5;
+	const uinteger_t d("10000000000000000000000000000000000000001", 16);
+	const uinteger_t e = 12345;
+	const auto L = [](const uinteger_t& num) { return uinteger_t::lazy(num); };
+
+	uinteger_t r = L(a) * b + L(c) * d - e;
+	EXPECT_EQ(r, a * b + c * d - e);
+
+	r = L(a) * b + c * d - e;  // c * d is eager
+	EXPECT_EQ(r, a * b + c * d - e);
+
+	r = c + L(a) * b;
+	EXPECT_EQ(r, c + a * b);
+
+	r = (L(a) + b) * (c - d);
+	EXPECT_EQ(r, (a + b) * (c - d));
+
+	r = L(c) * d - (L(a) * b - e);
+	EXPECT_EQ(r, c * d - (a * b - e));
+
+	// a bracketed difference must not underflow the running result
+	const uinteger_t x = uinteger_t(1) << 128;
+	const uinteger_t y = x - 5;
+	const uinteger_t z = 10;
+	const uinteger_t f = 5, g = 3, h = 7;
+	r = L(f) - (L(h) - g);
+	EXPECT_EQ(r, f - (h - g));
+	EXPECT_EQ(r, 1);
+	r = L(z) - (L(x) - y);
+	EXPECT_EQ(r, z - (x - y));
+	EXPECT_EQ(r, 5);
+	r = z;
+	r -= L(x) - y;
+	EXPECT_EQ(r, 5);
+	r = L(f) + (L(g) - h);
+	EXPECT_EQ(r, f + (g - h));
+	const uinteger_t w = uinteger_t(1) << 64;
+	r = f - (L(h) + w);
+	EXPECT_EQ(r, f - (h + w));
+	r = f;
+	r -= L(h) + w;
+	EXPECT_EQ(r, f - (h + w));
+
+	r = L(a) * a;
+	EXPECT_EQ(r, a.sqr());
+
+	r = d;
+	r += L(a) * b;
+	EXPECT_EQ(r, d + a * b);
+	r -= L(a) * b;
+	EXPECT_EQ(r, d);
+
+	// the destination can be an operand too
+	r = a;
+	r = L(r) * b + r;
+	EXPECT_EQ(r, a * b + a);
+	r += L(r) * r;
+	EXPECT_EQ(r, (a * b + a) * (a * b + a + 1));
+}
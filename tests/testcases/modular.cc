@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include "uinteger_t.hh"
+
+TEST(Modular, montgomery) {
+	const uinteger_t one = 1;
+	for (std::size_t bits : {61, 127, 521, 1279, 4423}) {
+		// Mersenne primes, and some other odd moduli
+		for (const auto& m : {(one << bits) - 1, (one << bits) + 3, (one << bits) - 1 + (one << (bits / 2))}) {
+			const uinteger_t::montgomery_ctx ctx(m);
+			EXPECT_EQ(ctx.modulus(), m);
+
+			const auto a = (one << (bits - 1)) + 0x0123456789abcdefULL;
+			const auto b = (one << (bits - 3)) - 0xfedcba9876543210ULL;
+			const auto c = m * 3 + 5;  // not reduced
+			EXPECT_EQ(ctx.mulmod(a, b), a * b % m);
+			EXPECT_EQ(ctx.mulmod(a, a), a * a % m);
+			EXPECT_EQ(ctx.mulmod(c, b), c * b % m);
+			EXPECT_EQ(ctx.mulmod(m - 1, m - 1), 1);
+			EXPECT_EQ(ctx.mulmod(a, 0), 0);
+
+			// products of numbers in Montgomery form stay in Montgomery form
+			const auto am = ctx.to_montgomery(a);
+			const auto bm = ctx.to_montgomery(b);
+			EXPECT_EQ(ctx.from_montgomery(am), a);
+			EXPECT_EQ(ctx.from_montgomery(ctx.mult(am, bm)), a * b % m);
+			EXPECT_EQ(ctx.from_montgomery(ctx.sqr(am)), a * a % m);
+			EXPECT_EQ(ctx.sqr(am), ctx.mult(am, uinteger_t(am)));
+		}
+	}
+
+	// single digit moduli
+	const uinteger_t::montgomery_ctx small(1000003);
+	EXPECT_EQ(small.mulmod(999999, 999998), (999999ULL * 999998ULL) % 1000003);
+	const uinteger_t::montgomery_ctx unit(1);
+	EXPECT_EQ(unit.mulmod(5, 7), 0);
+
+	EXPECT_THROW(uinteger_t::montgomery_ctx(one << 100), std::domain_error);
+	EXPECT_THROW(uinteger_t::montgomery_ctx(0), std::domain_error);
+}
+
+TEST(Modular, montgomery_kernels) {
+	// a whole computation on preallocated buffers
+	const uinteger_t one = 1;
+	const auto m = (one << 607) - 1;
+	const auto a = (one << 600) + 12345;
+	const uinteger_t::montgomery_ctx ctx(m);
+
+	auto n = ctx.size();
+	std::vector<uinteger_t::digit> x(n), scratch(ctx.scratch_size());
+	std::copy(a.begin(), a.end(), x.begin());
+	ctx.to_montgomery(x.data(), x.data(), scratch.data());
+	auto expected = a;
+	for (int i = 0; i < 10; ++i) {
+		ctx.sqr(x.data(), x.data(), scratch.data());
+		expected = expected * expected % m;
+	}
+	ctx.from_montgomery(x.data(), x.data(), scratch.data());
+	uinteger_t result;
+	for (auto it = x.rbegin(); it != x.rend(); ++it) {
+		result = (result << uinteger_t::digit_bits) | *it;
+	}
+	EXPECT_EQ(result, expected);
+}
+
+static uinteger_t naive_powmod(uinteger_t base, const uinteger_t& exp, const uinteger_t& mod) {
+	uinteger_t result = 1 % mod;
+	base %= mod;
+	for (std::size_t i = 0; i < exp.bits(); ++i) {
+		if (exp[i]) {
+			result = result * base % mod;
+		}
+		base = base * base % mod;
+	}
+	return result;
+}
+
+TEST(Modular, powmod) {
+	EXPECT_EQ(uinteger_t::powmod(4, 13, 497), 445);
+	EXPECT_EQ(uinteger_t::powmod(4, 13, 496), naive_powmod(4, 13, 496));
+	EXPECT_EQ(uinteger_t::powmod(2, 0, 7), 1);
+	EXPECT_EQ(uinteger_t::powmod(2, 0, 8), 1);
+	EXPECT_EQ(uinteger_t::powmod(2, 5, 1), 0);
+	EXPECT_EQ(uinteger_t::powmod(0, 5, 9), 0);
+	EXPECT_EQ(uinteger_t::powmod(10, 5, 1024), 100000 % 1024);
+	EXPECT_THROW(uinteger_t::powmod(2, 5, 0), std::domain_error);
+
+	// Fermat's little theorem, for the Mersenne prime 2^521 - 1
+	const uinteger_t one = 1;
+	const auto p = (one << 521) - 1;
+	const uinteger_t a("9f2c5d3a7b1e8f604c2d9e5a3b7c1f8e0d4a6b2c9e5f1a3d7b8c0e2f4a6d9b1c3e5f7a8", 16);
+	EXPECT_EQ(uinteger_t::powmod(a, p - 1, p), 1);
+	EXPECT_EQ(uinteger_t::powmod(a, p, p), a);
+
+	// exponents of every window size, odd and even moduli
+	const uinteger_t::montgomery_ctx ctx(p);
+	for (std::size_t bits : {1, 5, 20, 70, 200, 600, 1500, 2500}) {
+		const auto e = (one << bits) - 0x5a5a5a5a5a5a5a5bULL % (one << bits);
+		for (const auto& m : {p, p + 1, (one << 700) + 2, uinteger_t(1000004)}) {
+			EXPECT_EQ(uinteger_t::powmod(a, e, m), naive_powmod(a, e, m));
+		}
+		EXPECT_EQ(uinteger_t::powmod(a, e, ctx), naive_powmod(a, e, p));
+	}
+}
+
+TEST(Modular, barrett) {
+	const uinteger_t one = 1;
+	for (std::size_t bits : {60, 64, 128, 521, 1280, 4500}) {
+		for (const auto& m : {(one << bits), (one << bits) - 2, (one << bits) + 12345678, (one << (bits - 1)) + 1}) {
+			const uinteger_t::barrett_ctx ctx(m);
+			EXPECT_EQ(ctx.modulus(), m);
+
+			const auto a = m - 0x0123456789abcdefULL % m;
+			const auto b = (m >> 3) + 0xfedcba9876543210ULL;
+			const auto c = m * m - 1;
+			EXPECT_EQ(ctx.reduce(a * b), a * b % m);
+			EXPECT_EQ(ctx.reduce(c), c % m);
+			EXPECT_EQ(ctx.reduce(c * m + 7), 7 % m);  // too big, takes a division
+			EXPECT_EQ(ctx.reduce(b), b % m);
+			EXPECT_EQ(ctx.reduce(0), 0);
+			EXPECT_EQ(ctx.mulmod(a, b), a * b % m);
+			EXPECT_EQ(ctx.mulmod(c, b), c * b % m);
+			EXPECT_EQ(ctx.sqrmod(a), a * a % m);
+			EXPECT_EQ(ctx.sqrmod(m - 1), 1 % m);
+		}
+	}
+	const uinteger_t::barrett_ctx small(1000004);
+	EXPECT_EQ(small.mulmod(999999, 999998), (999999ULL * 999998ULL) % 1000004);
+	EXPECT_EQ(uinteger_t::barrett_ctx(1).mulmod(5, 7), 0);
+	EXPECT_THROW(uinteger_t::barrett_ctx(0), std::domain_error);
+
+	const auto a = (one << 1000) - 3;
+	const auto e = (one << 300) + 17;
+	const auto m = (one << 1024) + 2;
+	EXPECT_EQ(uinteger_t::powmod(a, e, uinteger_t::barrett_ctx(m)), uinteger_t::powmod(a, e, m));
+	EXPECT_EQ(uinteger_t::powmod(a, e, uinteger_t::barrett_ctx(m + 1)), uinteger_t::powmod(a, e, uinteger_t::montgomery_ctx(m + 1)));
+}
+
+static uinteger_t naive_gcd(uinteger_t a, uinteger_t b) {
+	while (b) {
+		auto r = a % b;
+		a = std::move(b);
+		b = std::move(r);
+	}
+	return a;
+}
+
+TEST(Modular, gcd) {
+	const uinteger_t one = 1;
+	EXPECT_EQ(uinteger_t::gcd(0, 0), 0);
+	EXPECT_EQ(uinteger_t::gcd(0, 12), 12);
+	EXPECT_EQ(uinteger_t::gcd(12, 0), 12);
+	EXPECT_EQ(uinteger_t::gcd(12, 18), 6);
+	EXPECT_EQ(uinteger_t::lcm(12, 18), 36);
+	EXPECT_EQ(uinteger_t::lcm(0, 18), 0);
+
+	// Fibonacci numbers, the worst case for Euclid's algorithm
+	uinteger_t f0 = 0, f1 = 1;
+	for (int i = 0; i < 3000; ++i) {
+		f0 += f1;
+		std::swap(f0, f1);
+	}
+	EXPECT_EQ(uinteger_t::gcd(f1, f0), 1);
+	EXPECT_EQ(uinteger_t::gcd(f1 * 12345, f0 * 12345), 12345);
+
+	// up to sizes using the half-GCD
+	for (std::size_t bits : {64, 200, 1000, 10000, 40000}) {
+		const auto g = (one << (bits / 3)) + 0x1234567;
+		auto a = (one << bits) / 7 + 1;
+		auto b = (one << (bits - 5)) / 3 + 0x89abcdef;
+		EXPECT_EQ(uinteger_t::gcd(a, b), naive_gcd(a, b));
+		EXPECT_EQ(uinteger_t::gcd(a * g, b * g), naive_gcd(a * g, b * g));
+		EXPECT_EQ(uinteger_t::gcd(b * g, a * g), naive_gcd(a * g, b * g));
+		EXPECT_EQ(uinteger_t::gcd(a * g, g), g);
+		EXPECT_EQ(uinteger_t::lcm(a * g, b * g), a * g * b * g / naive_gcd(a * g, b * g));
+	}
+}
+
+TEST(Modular, gcdext) {
+	const uinteger_t one = 1;
+	auto check = [](const uinteger_t& a, const uinteger_t& b) {
+		auto r = uinteger_t::gcdext(a, b);
+		EXPECT_EQ(r.gcd, naive_gcd(a, b));
+		if (r.x_negative) {
+			EXPECT_EQ(b * r.y - a * r.x, r.gcd);
+		} else {
+			EXPECT_EQ(a * r.x - b * r.y, r.gcd);
+		}
+	};
+	check(240, 46);
+	check(46, 240);
+	check(5, 0);
+	check(0, 5);
+	check(7, 7);
+	for (std::size_t bits : {64, 200, 1000, 10000, 40000}) {
+		const auto g = (one << (bits / 3)) + 0x1234567;
+		auto a = (one << bits) / 7 + 1;
+		auto b = (one << (bits - 5)) / 3 + 0x89abcdef;
+		check(a, b);
+		check(b, a);
+		check(a * g, b * g);
+	}
+
+	EXPECT_EQ(uinteger_t::invmod(3, 7), 5);
+	EXPECT_EQ(uinteger_t::invmod(10, 7), 5);
+	EXPECT_EQ(uinteger_t::invmod(5, 1), 0);
+	const auto m = (one << 4423) - 1;
+	const auto a = (one << 3000) + 12345;
+	EXPECT_EQ(a * uinteger_t::invmod(a, m) % m, 1);
+	EXPECT_THROW(uinteger_t::invmod(6, 9), std::domain_error);
+	EXPECT_THROW(uinteger_t::invmod(6, 0), std::domain_error);
+}
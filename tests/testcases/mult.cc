@@ -49,3 +49,100 @@ TEST(External, inplace) {
 	}
 	EXPECT_EQ(val, 0x3ade68b1);
 }
+
+TEST(Arithmetic, multiply_large) {
+	// sizes around and well above the Karatsuba, Toom-Cook and NTT cutoffs,
+	// balanced and lopsided
+	const uinteger_t one = 1;
+	for (const auto& sizes : std::vector<std::pair<std::size_t, std::size_t>>{{1500, 1500}, {20000, 20000}, {20000, 27000}, {20000, 35000}, {17000, 60000}, {40000, 50000}, {300000, 300000}, {270000, 900000}}) {
+		const auto a = (one << sizes.first) - 1;
+		const auto b = (one << sizes.second) - 1;
+		// (2^n - 1) * (2^m - 1) = 2^(n + m) - 2^n - 2^m + 1
+		const auto expected = (one << (sizes.first + sizes.second)) - (one << sizes.first) - (one << sizes.second) + 1;
+		EXPECT_EQ(a * b, expected);
+		EXPECT_EQ(b * a, expected);
+	}
+
+	uinteger_t x("9f2c5d3a7b1e8f604c2d9e5a3b7c1f8e0d4a6b2c9e5f1a3d7b8c0e2f4a6d9b1c3e5f7a8", 16);
+	uinteger_t y("e1d2c3b4a5968778695a4b3c2d1e0f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5", 16);
+	for (int i = 0; i < 8; ++i) {
+		x = x * x + 1;
+		y = y * y + 3;
+	}
+	const auto product = x * y;
+	EXPECT_EQ(product / x, y);
+	EXPECT_EQ(product % x, 0);
+	EXPECT_EQ(product / y, x);
+	EXPECT_EQ(product % y, 0);
+}
+
+TEST(Arithmetic, square) {
+	const uinteger_t val(0xfedbca9876543210ULL);
+	EXPECT_EQ(val.sqr(), uinteger_t(0xfdb8e2bacbfe7cefULL, 0x010e6cd7a44a4100ULL));
+	EXPECT_EQ(uinteger_t(0).sqr(), 0);
+	EXPECT_EQ(uinteger_t(1).sqr(), 1);
+
+	// sizes around the Karatsuba, Toom-Cook and NTT cutoffs
+	const uinteger_t one = 1;
+	for (std::size_t bits : {64, 65, 1000, 1100, 3000, 17000, 20000, 50000, 300000}) {
+		const auto a = (one << bits) - 1;
+		// (2^n - 1)^2 = 2^(2 n) - 2^(n + 1) + 1
+		const auto expected = (one << (2 * bits)) - (one << (bits + 1)) + 1;
+		EXPECT_EQ(a.sqr(), expected);
+		EXPECT_EQ(a * a, expected);
+	}
+
+	// squaring agrees with multiplying two distinct copies
+	uinteger_t x("9f2c5d3a7b1e8f604c2d9e5a3b7c1f8e0d4a6b2c9e5f1a3d7b8c0e2f4a6d9b1c3e5f7a8", 16);
+	for (int i = 0; i < 10; ++i) {
+		const uinteger_t y(x);
+		const auto s = x.sqr();
+		EXPECT_EQ(s, x * y);
+		x = s + 0x123456789abcdefULL;
+	}
+}
+
+TEST(Arithmetic, multiply_accumulate) {
+	const uinteger_t one = 1;
+	const auto a = (one << 300) - 12345;
+	const auto b = (one << 200) + 0xfedbca9876543210ULL;
+	const auto c = (one << 2000) - 1;
+	const uinteger_t d = 0x9e3779b97f4a7c15ULL;
+
+	uinteger_t acc = 42;
+	acc.addmul(a, b);
+	EXPECT_EQ(acc, a * b + 42);
+	acc.submul(a, b);
+	EXPECT_EQ(acc, 42);
+	acc.addmul(c, c);
+	EXPECT_EQ(acc, c * c + 42);
+	acc.submul(c, c);
+	EXPECT_EQ(acc, 42);
+
+	// single digit operands, native or not
+	acc.addmul(a, 1000u);
+	EXPECT_EQ(acc, a * 1000 + 42);
+	acc.addmul(d, a);
+	EXPECT_EQ(acc, a * 1000 + a * d + 42);
+	acc.submul(a, d);
+	acc.submul(a, 1000u);
+	EXPECT_EQ(acc, 42);
+
+	// the accumulator can be an operand
+	acc = a;
+	acc.addmul(acc, 3);
+	EXPECT_EQ(acc, a * 4);
+	acc.addmul(acc, b);
+	EXPECT_EQ(acc, a * 4 * (b + 1));
+
+	// wraps around like subtraction
+	uinteger_t small = 5;
+	small.submul(d, 2);
+	EXPECT_EQ(small, uinteger_t(5) - d * 2);
+
+	const std::vector<uinteger_t> prices{a, b, c, d, 7};
+	const std::vector<uinteger_t> quantities{3, b, c, a};
+	EXPECT_EQ(uinteger_t::dot(prices, quantities), a * 3 + b * b + c * c + d * a);
+	EXPECT_EQ(uinteger_t::dot(std::vector<int>{1, 2, 3}, std::vector<unsigned>{4, 5, 6}), 32);
+	EXPECT_EQ(uinteger_t::dot(prices, std::vector<uinteger_t>{}), 0);
+}
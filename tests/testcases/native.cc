@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "uinteger_t.hh"
+
+TEST(Native, arithmetic) {
+	// native operands give the same results as uinteger_t operands
+	const uinteger_t one = 1;
+	const std::vector<uinteger_t> values{
+		0,
+		1,
+		0xffffffffffffffffULL,
+		(one << 128) - 1,
+		(one << 192),
+		uinteger_t("123456789abcdef0fedcba9876543210deadbeefcafebabe", 16),
+	};
+	for (const auto& val : values) {
+		for (std::uint64_t rhs : {1ULL, 3ULL, 10ULL, 97ULL, 0x8000000000000000ULL, 0xffffffffffffffffULL}) {
+			const uinteger_t big_rhs = rhs;
+			EXPECT_EQ(val + rhs, val + big_rhs);
+			EXPECT_EQ(val - rhs, val - big_rhs);
+			EXPECT_EQ(val * rhs, val * big_rhs);
+			EXPECT_EQ(val / rhs, val / big_rhs);
+			EXPECT_EQ(val % rhs, val % big_rhs);
+			EXPECT_EQ(val & rhs, val & big_rhs);
+			EXPECT_EQ(val | rhs, val | big_rhs);
+			EXPECT_EQ(val ^ rhs, val ^ big_rhs);
+			EXPECT_EQ(val < rhs, val < big_rhs);
+			EXPECT_EQ(val > rhs, val > big_rhs);
+			EXPECT_EQ(val == rhs, val == big_rhs);
+
+			auto x = val;
+			x *= rhs;
+			x += rhs;
+			EXPECT_EQ(x, val * big_rhs + big_rhs);
+			x -= rhs;
+			x /= rhs;
+			EXPECT_EQ(x, val);
+			x %= rhs;
+			EXPECT_EQ(x, val % big_rhs);
+		}
+	}
+
+	// digits accumulated the usual way
+	uinteger_t num;
+	for (auto c : std::string("340282366920938463463374607431768211455")) {
+		num = num * 10 + (c - '0');
+	}
+	EXPECT_EQ(num, (one << 128) - 1);
+	EXPECT_EQ(num % 97, 34);
+
+	EXPECT_THROW(num / 0, std::domain_error);
+	EXPECT_THROW(num % 0, std::domain_error);
+}
+
+TEST(Native, left_operand) {
+	// native left operands give the same results as uinteger_t ones
+	const uinteger_t one = 1;
+	const std::vector<uinteger_t> values{
+		0,
+		1,
+		5,
+		63,
+		64,
+		97,
+		0xffffffffffffffffULL,
+		(one << 128) - 1,
+		(one << 192),
+		uinteger_t("123456789abcdef0fedcba9876543210deadbeefcafebabe", 16),
+	};
+	for (const auto& val : values) {
+		for (std::uint64_t lhs : {0ULL, 1ULL, 7ULL, 97ULL, 0x8000000000000000ULL, 0xffffffffffffffffULL}) {
+			const uinteger_t big_lhs = lhs;
+			EXPECT_EQ(lhs - val, big_lhs - val);
+			EXPECT_EQ(lhs - uinteger_t(val), big_lhs - val);
+			EXPECT_EQ(lhs >> val, big_lhs >> val);
+			if (val < 256) {
+				EXPECT_EQ(lhs << val, big_lhs << val);
+			}
+			if (val) {
+				EXPECT_EQ(lhs / val, big_lhs / val);
+				EXPECT_EQ(lhs % val, big_lhs % val);
+
+				auto x = lhs;
+				x /= val;
+				EXPECT_EQ(x, big_lhs / val);
+				x = lhs;
+				x %= val;
+				EXPECT_EQ(x, big_lhs % val);
+			}
+			auto x = lhs;
+			x -= val;
+			EXPECT_EQ(x, static_cast<std::uint64_t>(big_lhs - val));
+		}
+	}
+
+	EXPECT_THROW(5 / uinteger_t(0), std::domain_error);
+	EXPECT_THROW(5 % uinteger_t(0), std::domain_error);
+}
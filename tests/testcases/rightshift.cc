@@ -50,6 +50,25 @@ TEST(BitShift, right2) {
 	}
 }
 
+TEST(BitShift, round_trip) {
+	// native shift counts and uinteger_t shift counts agree, and shifting
+	// back down restores the value
+	const uinteger_t val("123456789abcdef0fedcba9876543210deadbeefcafebabe", 16);
+	for (std::size_t bits = 0; bits < 300; bits += 7) {
+		auto shifted = val << bits;
+		EXPECT_EQ(shifted, val << uinteger_t(bits));
+		EXPECT_EQ(shifted >> bits, val);
+		EXPECT_EQ(val >> bits, val >> uinteger_t(bits));
+
+		auto in_place = val;
+		in_place <<= bits;
+		EXPECT_EQ(in_place, shifted);
+		in_place >>= bits;
+		EXPECT_EQ(in_place, val);
+	}
+	EXPECT_EQ(val >> (uinteger_t(1) << 100), 0);
+}
+
 TEST(External, shift_right) {
 	bool     t   = true;
 	bool     f   = false;
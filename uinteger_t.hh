@@ -38,17 +38,23 @@ to header-only and extended to arbitrary bit length.
 #ifndef __uint_t__
 #define __uint_t__
 
+#include <array>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <cassert>
+#include <cstddef>
 #include <utility>
 #include <cstring>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <algorithm>
 #include <stdexcept>
 #include <functional>
 #include <type_traits>
+#include <system_error>
 
 #define ASSERT assert
 
@@ -67,6 +73,7 @@ to header-only and extended to arbitrary bit length.
 #  define HAVE___UMUL128
 #  define HAVE___UMUL64
 #  define HAVE___UMUL32
+#  define HAVE___BYTESWAP_UINT64
 #  include <intrin.h>
 #endif
 
@@ -79,6 +86,18 @@ to header-only and extended to arbitrary bit length.
 #if (defined(__clang__) && __has_builtin(__builtin_clz)) || (defined(__GNUC__ ) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 3)))
 #  define HAVE____BUILTIN_CLZ
 #endif
+#if (defined(__clang__) && __has_builtin(__builtin_ctzll)) || (defined(__GNUC__ ) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)))
+#  define HAVE____BUILTIN_CTZLL
+#endif
+#if (defined(__clang__) && __has_builtin(__builtin_ctzl)) || (defined(__GNUC__ ) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)))
+#  define HAVE____BUILTIN_CTZL
+#endif
+#if (defined(__clang__) && __has_builtin(__builtin_ctz)) || (defined(__GNUC__ ) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)))
+#  define HAVE____BUILTIN_CTZ
+#endif
+#if (defined(__clang__) && __has_builtin(__builtin_bswap64)) || (defined(__GNUC__ ) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)))
+#  define HAVE____BUILTIN_BSWAP64
+#endif
 #if (defined(__clang__) && __has_builtin(__builtin_addcll))
 #  define HAVE____BUILTIN_ADDCLL
 #endif
@@ -102,6 +121,22 @@ to header-only and extended to arbitrary bit length.
 #define HAVE____INT128_T
 #endif
 
+#if (defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined _M_X64 || defined _M_IX86 || defined _M_ARM64
+#define HAVE_LITTLE_ENDIAN
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined __has_include
+#  if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#    define HAVE_STD_PMR
+#    include <memory_resource>
+#  endif
+#endif
+
 
 #ifndef DIGIT_T
 #define DIGIT_T        std::uint64_t
@@ -111,8 +146,15 @@ to header-only and extended to arbitrary bit length.
 #define HALF_DIGIT_T   std::uint32_t
 #endif
 
+#ifndef INLINE_BITS
+#define INLINE_BITS    256
+#endif
+
 class uinteger_t;
 
+template <std::size_t Bits>
+class fixed_uinteger_t;
+
 namespace std {  // This is probably not a good idea
 	// Give uinteger_t type traits
 	template <> struct is_arithmetic <uinteger_t> : std::true_type {};
@@ -130,7 +172,372 @@ public:
 	static constexpr std::size_t half_digit_octets = sizeof(half_digit);   // number of octets per half_digit
 	static constexpr std::size_t half_digit_bits = half_digit_octets * 8;  // number of bits per half_digit
 
-	using container = std::vector<digit>;
+	static constexpr std::size_t inline_digits = INLINE_BITS / digit_bits; // number of digits stored inline
+
+	// Memory resources
+	// All digits storage is obtained from a polymorphic memory resource. By default
+	// it's the global heap, but a different one (e.g. an arena) can be given to any
+	// number or installed as the default for the current thread, in which case every
+	// temporary used internally by the algorithms is allocated from it as well.
+#if defined HAVE_STD_PMR
+	using memory_resource = std::pmr::memory_resource;
+
+	static memory_resource* new_delete_resource() noexcept {
+		return std::pmr::new_delete_resource();
+	}
+#else
+	class memory_resource {
+	public:
+		virtual ~memory_resource() { }
+
+		void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+			return do_allocate(bytes, alignment);
+		}
+
+		void deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+			do_deallocate(p, bytes, alignment);
+		}
+
+		bool is_equal(const memory_resource& other) const noexcept {
+			return do_is_equal(other);
+		}
+
+	private:
+		virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+		virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+		virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+	};
+
+	static memory_resource* new_delete_resource() noexcept {
+		class new_delete : public memory_resource {
+			void* do_allocate(std::size_t bytes, std::size_t) override {
+				return ::operator new(bytes);
+			}
+			void do_deallocate(void* p, std::size_t, std::size_t) override {
+				::operator delete(p);
+			}
+			bool do_is_equal(const memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+		};
+		static new_delete resource;
+		return &resource;
+	}
+#endif
+
+	// Memory resource which hands out memory from a growing list of buffers and
+	// only releases it all at once (when destroyed or when `release()` is called).
+	class monotonic_buffer_resource : public memory_resource {
+		struct chunk {
+			chunk* next;
+			std::size_t size;
+		};
+
+		memory_resource* _upstream;
+		chunk* _chunks;
+		char* _current;
+		std::size_t _available;
+		std::size_t _next_size;
+		char* _initial_buffer;
+		std::size_t _initial_available;
+		std::size_t _initial_next_size;
+
+		void _expand(std::size_t bytes, std::size_t alignment) {
+			auto size = std::max(_next_size, bytes + alignment + sizeof(chunk));
+			auto c = static_cast<chunk*>(_upstream->allocate(size, alignof(chunk)));
+			c->next = _chunks;
+			c->size = size;
+			_chunks = c;
+			_current = reinterpret_cast<char*>(c + 1);
+			_available = size - sizeof(chunk);
+			_next_size = static_cast<std::size_t>(size * growth_factor);
+		}
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			auto padding = (alignment - reinterpret_cast<std::uintptr_t>(_current) % alignment) % alignment;
+			if (!_current || padding + bytes > _available) {
+				_expand(bytes, alignment);
+				padding = (alignment - reinterpret_cast<std::uintptr_t>(_current) % alignment) % alignment;
+			}
+			auto p = _current + padding;
+			_current = p + bytes;
+			_available -= padding + bytes;
+			return p;
+		}
+
+		void do_deallocate(void*, std::size_t, std::size_t) override { }
+
+		bool do_is_equal(const memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+	public:
+		explicit monotonic_buffer_resource(std::size_t initial_size = 4096, memory_resource* upstream = new_delete_resource()) :
+			_upstream(upstream),
+			_chunks(nullptr),
+			_current(nullptr),
+			_available(0),
+			_next_size(initial_size + sizeof(chunk)),
+			_initial_buffer(nullptr),
+			_initial_available(0),
+			_initial_next_size(_next_size) { }
+
+		monotonic_buffer_resource(void* buffer, std::size_t buffer_size, memory_resource* upstream = new_delete_resource()) :
+			_upstream(upstream),
+			_chunks(nullptr),
+			_current(static_cast<char*>(buffer)),
+			_available(buffer_size),
+			_next_size(buffer_size + sizeof(chunk)),
+			_initial_buffer(_current),
+			_initial_available(buffer_size),
+			_initial_next_size(_next_size) { }
+
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+		~monotonic_buffer_resource() {
+			release();
+		}
+
+		// Frees every chunk taken from upstream and starts over from the initial
+		// buffer (if one was given), as std::pmr::monotonic_buffer_resource does.
+		void release() {
+			while (_chunks) {
+				auto next = _chunks->next;
+				_upstream->deallocate(_chunks, _chunks->size, alignof(chunk));
+				_chunks = next;
+			}
+			_current = _initial_buffer;
+			_available = _initial_available;
+			_next_size = _initial_next_size;
+		}
+
+		memory_resource* upstream_resource() const noexcept {
+			return _upstream;
+		}
+	};
+
+private:
+	static memory_resource*& _default_resource() noexcept {
+		static thread_local memory_resource* resource = new_delete_resource();
+		return resource;
+	}
+
+public:
+	// Resource used by numbers (and all internal temporaries) created in the current thread
+	static memory_resource* get_default_resource() noexcept {
+		return _default_resource();
+	}
+
+	static memory_resource* set_default_resource(memory_resource* resource) noexcept {
+		auto& current = _default_resource();
+		auto previous = current;
+		current = resource ? resource : new_delete_resource();
+		return previous;
+	}
+
+	// Installs a default resource for the current thread during its lifetime.
+	class default_resource_guard {
+		memory_resource* _previous;
+
+	public:
+		explicit default_resource_guard(memory_resource* resource) noexcept :
+			_previous(set_default_resource(resource)) { }
+
+		default_resource_guard(const default_resource_guard&) = delete;
+		default_resource_guard& operator=(const default_resource_guard&) = delete;
+
+		~default_resource_guard() {
+			set_default_resource(_previous);
+		}
+	};
+
+	// Vector-like digits container which keeps up to `inline_digits` digits
+	// inside the object itself and only spills to the memory resource when it
+	// grows beyond that, so small numbers never touch the allocator.
+	class container {
+	public:
+		using value_type = digit;
+		using size_type = std::size_t;
+		using reference = digit&;
+		using const_reference = const digit&;
+		using iterator = digit*;
+		using const_iterator = const digit*;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	private:
+		memory_resource* _resource;
+		digit* _data;
+		std::size_t _size;
+		std::size_t _capacity;
+		digit _inline[inline_digits ? inline_digits : 1];
+
+		bool _is_inline() const noexcept {
+			return _data == _inline;
+		}
+
+		void _deallocate() noexcept {
+			if (!_is_inline()) {
+				_resource->deallocate(_data, _capacity * sizeof(digit), alignof(digit));
+			}
+		}
+
+		void _reallocate(std::size_t cap) {
+			auto data = static_cast<digit*>(_resource->allocate(cap * sizeof(digit), alignof(digit)));
+			std::copy(_data, _data + _size, data);
+			_deallocate();
+			_data = data;
+			_capacity = cap;
+		}
+
+		void _steal(container& o) noexcept {
+			if (o._is_inline()) {
+				_data = _inline;
+				_capacity = sizeof(_inline) / sizeof(digit);
+				std::copy(o._data, o._data + o._size, _data);
+			} else {
+				_data = o._data;
+				_capacity = o._capacity;
+				o._data = o._inline;
+				o._capacity = sizeof(o._inline) / sizeof(digit);
+			}
+			_size = o._size;
+			o._size = 0;
+		}
+
+	public:
+		explicit container(memory_resource* resource = get_default_resource()) noexcept :
+			_resource(resource),
+			_data(_inline),
+			_size(0),
+			_capacity(sizeof(_inline) / sizeof(digit)) { }
+
+		template <typename InputIt>
+		container(InputIt first, InputIt last, memory_resource* resource = get_default_resource()) :
+			container(resource) {
+			auto sz = static_cast<std::size_t>(std::distance(first, last));
+			reserve(sz);
+			std::copy(first, last, _data);
+			_size = sz;
+		}
+
+		container(const container& o) :
+			container(o.begin(), o.end()) { }
+
+		container(container&& o) noexcept :
+			_resource(o._resource) {
+			_steal(o);
+		}
+
+		~container() {
+			_deallocate();
+		}
+
+		container& operator=(const container& o) {
+			if (this != &o) {
+				assign(o.begin(), o.end());
+			}
+			return *this;
+		}
+
+		// [first, last) can be a part of this same container
+		void assign(const_iterator first, const_iterator last) {
+			auto sz = static_cast<std::size_t>(last - first);
+			if (sz > _capacity) {
+				// (then it can't be a part of this container)
+				_size = 0;
+				reserve(sz);
+			}
+			if (first != _data) {
+				std::copy(first, last, _data);
+			}
+			_size = sz;
+		}
+
+		container& operator=(container&& o) {
+			if (this != &o) {
+				if (_resource == o._resource || _resource->is_equal(*o._resource)) {
+					_deallocate();
+					_steal(o);
+				} else {
+					// different resources, storage cannot be taken over
+					*this = static_cast<const container&>(o);
+				}
+			}
+			return *this;
+		}
+
+		memory_resource* resource() const noexcept {
+			return _resource;
+		}
+
+		void reserve(std::size_t cap) {
+			if (cap > _capacity) {
+				_reallocate(cap);
+			}
+		}
+
+		std::size_t capacity() const noexcept {
+			return _capacity;
+		}
+
+		std::size_t size() const noexcept {
+			return _size;
+		}
+
+		bool empty() const noexcept {
+			return !_size;
+		}
+
+		void resize(std::size_t sz, const digit& c = 0) {
+			if (sz > _capacity) {
+				_reallocate(std::max(sz, _capacity * 2));
+			}
+			if (sz > _size) {
+				std::fill(_data + _size, _data + sz, c);
+			}
+			_size = sz;
+		}
+
+		void clear() noexcept {
+			_size = 0;
+		}
+
+		iterator insert(const_iterator pos, std::size_t n, const digit& c) {
+			auto idx = pos - _data;
+			auto sz = _size + n;
+			if (sz > _capacity) {
+				_reallocate(std::max(sz, _capacity * 2));
+			}
+			std::copy_backward(_data + idx, _data + _size, _data + sz);
+			std::fill_n(_data + idx, n, c);
+			_size = sz;
+			return _data + idx;
+		}
+
+		digit* data() noexcept { return _data; }
+		const digit* data() const noexcept { return _data; }
+
+		reference operator[](std::size_t idx) noexcept { return _data[idx]; }
+		const_reference operator[](std::size_t idx) const noexcept { return _data[idx]; }
+
+		iterator begin() noexcept { return _data; }
+		const_iterator begin() const noexcept { return _data; }
+		const_iterator cbegin() const noexcept { return _data; }
+
+		iterator end() noexcept { return _data + _size; }
+		const_iterator end() const noexcept { return _data + _size; }
+		const_iterator cend() const noexcept { return _data + _size; }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+	};
 
 	template <typename T>
 	struct is_result {
@@ -151,6 +558,15 @@ private:
 	static_assert(digit_octets == half_digit_octets * 2, "half_digit must be exactly half the size of digit");
 
 	static constexpr std::size_t karatsuba_cutoff = 1024 / digit_bits;
+	static constexpr std::size_t toom3_cutoff = 16384 / digit_bits;
+	static constexpr std::size_t ntt_cutoff = 262144 / digit_bits;
+	static constexpr std::size_t burnikel_ziegler_cutoff = 6144 / digit_bits;
+	static constexpr std::size_t newton_cutoff = 1048576 / digit_bits;
+	static constexpr std::size_t hgcd_cutoff = 4096 / digit_bits;
+	static constexpr std::size_t gcd_hgcd_cutoff = 16384 / digit_bits;
+	static constexpr std::size_t str_cutoff = 1024 / digit_bits;
+	static constexpr std::size_t strtouint_cutoff = 16384 / digit_bits;
+	static constexpr std::size_t divrem_1_cutoff = 3;
 	static constexpr double growth_factor = 1.5;
 
 	std::size_t _begin;
@@ -159,6 +575,9 @@ private:
 	container& _value;
 	bool _carry;
 
+	template <std::size_t Bits>
+	friend class fixed_uinteger_t;
+
 public:
 	// Window to vector (uses _begin and _end)
 
@@ -170,7 +589,7 @@ public:
 		// expands the vector using a growth factor
 		// and returns the new capacity.
 		auto cc = _value.capacity();
-		if (n >= cc) {
+		if (n > cc) {
 			cc = n * growth_factor;
 			_value.reserve(cc);
 		}
@@ -356,6 +775,32 @@ private:
 		}
 	}
 
+	// Number of trailing zero bits, for a non-zero x
+	static digit _trailing_zeros(digit x) {
+	#if defined HAVE____BUILTIN_CTZLL
+		if (digit_octets == sizeof(unsigned long long)) {
+			return __builtin_ctzll(x);
+		}
+	#endif
+	#if defined HAVE____BUILTIN_CTZL
+		if (digit_octets == sizeof(unsigned long)) {
+			return __builtin_ctzl(x);
+		}
+	#endif
+	#if defined HAVE____BUILTIN_CTZ
+		if (digit_octets == sizeof(unsigned)) {
+			return __builtin_ctz(x);
+		}
+	#endif
+		{
+			digit c = 0;
+			for (; !(x & 1); x >>= 1) {
+				++c;
+			}
+			return c;
+		}
+	}
+
 	static digit _mult(digit x, digit y, digit* lo) {
 	#if defined HAVE___UMUL128
 		if (digit_bits == 64) {
@@ -548,6 +993,95 @@ private:
 		}
 	}
 
+	// Reciprocal of a normalized digit (with its top bit set),
+	// floor((BASE^2 - 1) / y) - BASE, used for dividing by y with multiplications
+	// (Möller and Granlund, "Improved division by invariant integers").
+	static digit _reciprocal(digit y) {
+		digit v;
+		_divmod(static_cast<digit>(~y), static_cast<digit>(~static_cast<digit>(0)), y, &v);
+		return v;
+	}
+
+	// Reciprocal of a normalized two digit number <y1, y0>,
+	// floor((BASE^3 - 1) / <y1, y0>) - BASE
+	static digit _reciprocal(digit y1, digit y0) {
+		auto v = _reciprocal(y1);
+		auto p = static_cast<digit>(y1 * v);
+		p = static_cast<digit>(p + y0);
+		if (p < y0) {
+			--v;
+			if (p >= y1) {
+				--v;
+				p = static_cast<digit>(p - y1);
+			}
+			p = static_cast<digit>(p - y1);
+		}
+		digit t0;
+		auto t1 = _mult(v, y0, &t0);
+		p = static_cast<digit>(p + t1);
+		if (p < t1) {
+			--v;
+			if (p > y1 || (p == y1 && t0 >= y0)) {
+				--v;
+			}
+		}
+		return v;
+	}
+
+	// Divides <x_hi, x_lo> by the normalized y (x_hi < y), v being the reciprocal
+	// of y, returns the remainder and leaves the quotient in result.
+	static digit _divmod(digit x_hi, digit x_lo, digit y, digit v, digit* result) {
+		digit q0;
+		auto q1 = _mult(v, x_hi, &q0);
+		auto carry = _addcarry(q0, x_lo, 0, &q0);
+		q1 = static_cast<digit>(q1 + x_hi + carry + 1);
+		auto r = static_cast<digit>(x_lo - q1 * y);
+		if (r > q0) {
+			--q1;
+			r = static_cast<digit>(r + y);
+		}
+		if (r >= y) {
+			++q1;
+			r = static_cast<digit>(r - y);
+		}
+		*result = q1;
+		return r;
+	}
+
+	// Divides <x2, x1, x0> by the normalized <y1, y0> (<x2, x1> < <y1, y0>), v being
+	// the reciprocal of <y1, y0>, leaves the quotient in result and the remainder in <r1, r0>.
+	static void _divmod(digit x2, digit x1, digit x0, digit y1, digit y0, digit v, digit* result, digit* r1, digit* r0) {
+		digit q0;
+		auto q1 = _mult(v, x2, &q0);
+		auto carry = _addcarry(q0, x1, 0, &q0);
+		q1 = static_cast<digit>(q1 + x2 + carry);
+
+		// <r1, r0> = <x1 - q1 y1, x0> - q1 y0 - <y1, y0>
+		auto _r1 = static_cast<digit>(x1 - q1 * y1);
+		digit _r0;
+		digit t0;
+		auto t1 = _mult(y0, q1, &t0);
+		auto borrow = _subborrow(x0, t0, 0, &_r0);
+		_subborrow(_r1, t1, borrow, &_r1);
+		borrow = _subborrow(_r0, y0, 0, &_r0);
+		_subborrow(_r1, y1, borrow, &_r1);
+
+		q1 = static_cast<digit>(q1 + 1);
+		if (_r1 >= q0) {
+			--q1;
+			carry = _addcarry(_r0, y0, 0, &_r0);
+			_addcarry(_r1, y1, carry, &_r1);
+		}
+		if (_r1 > y1 || (_r1 == y1 && _r0 >= y0)) {
+			++q1;
+			borrow = _subborrow(_r0, y0, 0, &_r0);
+			_subborrow(_r1, y1, borrow, &_r1);
+		}
+		*result = q1;
+		*r1 = _r1;
+		*r0 = _r0;
+	}
+
 	static digit _addcarry(digit x, digit y, digit c, digit* result) {
 	#if defined HAVE___ADDCARRY_U64
 		if (digit_bits == 64) {
@@ -709,38 +1243,18 @@ private:
 		resize(rit_e - rit_f); // shrink
 	}
 
+	// Character of a digit value, and digit value of a character (computed, as
+	// a lookup table can't be static in a constexpr function and would be copied
+	// on every call)
 	static constexpr char chr(int ord) {
-		constexpr const char _[256] = {
-			'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b',
-			'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n',
-			'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-		};
-		return _[ord];
+		return ord < 36 ? "0123456789abcdefghijklmnopqrstuvwxyz"[ord] : '\0';
 	}
 
 	static constexpr int ord(int chr) {
-		constexpr const int _[256] = {
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
-
-			-1, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
-			25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, -1,
-			-1, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
-			25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, -1,
-
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		};
-		return _[chr];
+		return chr >= '0' && chr <= '9' ? chr - '0' :
+			chr >= 'a' && chr <= 'z' ? chr - 'a' + 10 :
+			chr >= 'A' && chr <= 'Z' ? chr - 'A' + 10 :
+			-1;
 	}
 
 public:
@@ -794,16 +1308,72 @@ public:
 		return _[base - 1];
 	}
 
-	static const uinteger_t uint_0() {
-		static uinteger_t uint_0(0);
+	// Number of characters in the given base that always fit in a digit, and
+	// base raised to that (the largest power of the base a digit can hold)
+	static constexpr unsigned base_chunk_size(int base) {
+		unsigned size = 0;
+		for (auto max = static_cast<digit>(-1); max >= static_cast<digit>(base); max /= base) {
+			++size;
+		}
+		return size;
+	}
+
+	static constexpr digit base_chunk(int base) {
+		digit chunk = 1;
+		for (auto size = base_chunk_size(base); size; --size) {
+			chunk *= base;
+		}
+		return chunk;
+	}
+
+	static const uinteger_t& uint_0() {
+		static const uinteger_t uint_0(0);
 		return uint_0;
 	}
 
-	static const uinteger_t uint_1() {
-		static uinteger_t uint_1(1);
+	static const uinteger_t& uint_1() {
+		static const uinteger_t uint_1(1);
 		return uint_1;
 	}
 
+	// Divisor with the normalization and reciprocal precomputed, for dividing
+	// many numbers by the same value (see divmod() and operators / and %)
+	class divisor;
+
+	// Montgomery multiplication context, for many products with the same odd modulus
+	class montgomery_ctx;
+
+	// Barrett reduction context, for products with any modulus
+	class barrett_ctx;
+
+	// Expression templates (opt in by wrapping an operand with lazy()):
+	// `r = lazy(a) * b + lazy(c) * d - e` builds the whole expression and
+	// evaluates it straight into r, accumulating products with addmul()/submul().
+	// A product of two plain numbers (`c * d`) is not lazy and is computed eagerly.
+	// Expressions keep references to their operands, so they must be
+	// evaluated while those are still alive.
+	class lazy_node { };
+	class lazy_operand;
+	template <typename Lhs, typename Rhs, char Op>
+	class lazy_expression;
+
+	static lazy_operand lazy(const uinteger_t& num);
+
+	template <typename Node, typename = typename std::enable_if_t<std::is_base_of<lazy_node, Node>::value>>
+	static const Node& lazy(const Node& node) {
+		return node;
+	}
+
+	template <typename T>
+	using lazy_t = typename std::conditional_t<std::is_same<T, uinteger_t>::value, lazy_operand, T>;
+
+	// Lazy operators take at least one lazy operand, the other one can be a uinteger_t
+	template <typename Lhs, typename Rhs>
+	using enable_if_lazy_t = typename std::enable_if_t<
+		(std::is_base_of<lazy_node, Lhs>::value or std::is_base_of<lazy_node, Rhs>::value) and
+		(std::is_base_of<lazy_node, Lhs>::value or std::is_same<Lhs, uinteger_t>::value) and
+		(std::is_base_of<lazy_node, Rhs>::value or std::is_same<Rhs, uinteger_t>::value)>;
+
 private:
 	// Public Implementation
 #ifdef UINT_T_PUBLIC_IMPLEMENTATION
@@ -1063,141 +1633,106 @@ public:
 		return result;
 	}
 
-	static uinteger_t& bitwise_lshift(uinteger_t& lhs, const uinteger_t& rhs) {
-		if (!rhs) {
+	// Shift amount given as a uinteger_t (saturated, anything that large
+	// shifts everything out anyway)
+	static std::size_t _shift_amount(const uinteger_t& rhs) {
+		if (rhs.size() > 1) {
+			return std::numeric_limits<std::size_t>::max();
+		}
+		return static_cast<std::size_t>(rhs);
+	}
+
+	static uinteger_t& bitwise_lshift(uinteger_t& lhs, std::size_t rhs) {
+		if (!rhs || !lhs) {
 			return lhs;
 		}
 
-		uinteger_t shifts_q;
-		uinteger_t shifts_r;
 		auto _digit_bits = digit_bits;
-		auto uint_digit_bits = uinteger_t(_digit_bits);
-		divmod(shifts_q, shifts_r, rhs, uint_digit_bits);
-		std::size_t shifts = static_cast<std::size_t>(shifts_q);
-		std::size_t shift = static_cast<std::size_t>(shifts_r);
+		auto shifts = rhs / _digit_bits;
+		auto shift = rhs % _digit_bits;
 
-		if (shifts) {
-			lhs.prepend(shifts, 0);
-		}
-		if (shift) {
-			digit shifted = 0;
-			auto lhs_it = lhs.begin() + shifts;
-			auto lhs_it_e = lhs.end();
-			for (; lhs_it != lhs_it_e; ++lhs_it) {
-				auto v = (*lhs_it << shift) | shifted;
-				shifted = *lhs_it >> (_digit_bits - shift);
-				*lhs_it = v;
-			}
-			if (shifted) {
-				lhs.append(shifted);
-			}
-		}
+		// Shift the digits up in place, from the top down
+		auto lhs_sz = lhs.size();
+		lhs.resize(lhs_sz + shifts + 1);
+		auto data = lhs.data();
+		data[lhs_sz + shifts] = _lshift(data + shifts, data, lhs_sz, shift);
+		std::fill_n(data, shifts, 0);
 
 		// Finish up
 		lhs.trim();
 		return lhs;
 	}
 
-	static uinteger_t& bitwise_lshift(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t& bitwise_lshift(uinteger_t& result, const uinteger_t& lhs, std::size_t rhs) {
 		if (&result._value == &lhs._value) {
 			bitwise_lshift(result, rhs);
 			return result;
 		}
-		if (!rhs) {
+		if (!rhs || !lhs) {
 			result = lhs;
 			return result;
 		}
 
-		auto lhs_sz = lhs.size();
-
-		uinteger_t shifts_q;
-		uinteger_t shifts_r;
 		auto _digit_bits = digit_bits;
-		auto uint_digit_bits = uinteger_t(_digit_bits);
-		divmod(shifts_q, shifts_r, rhs, uint_digit_bits);
-		std::size_t shifts = static_cast<std::size_t>(shifts_q);
-		std::size_t shift = static_cast<std::size_t>(shifts_r);
-
-		auto result_sz = lhs_sz + shifts;
-		result.grow(result_sz + 1);
-		result.resize(shifts, 0);
-		result.resize(result_sz);
-
-		// not using `end()` because resize of `result.resize()` could have
-		// resized `lhs` if `result` is also `lhs`.
-		auto lhs_it = lhs.begin();
-		auto lhs_it_e = lhs_it + lhs_sz;
+		auto shifts = rhs / _digit_bits;
+		auto shift = rhs % _digit_bits;
 
-		auto it = result.begin() + shifts;
-
-		if (shift) {
-			digit shifted = 0;
-			for (; lhs_it != lhs_it_e; ++lhs_it, ++it) {
-				auto v = (*lhs_it << shift) | shifted;
-				shifted = *lhs_it >> (_digit_bits - shift);
-				*it = v;
-			}
-			if (shifted) {
-				result.append(shifted);
-			}
-		} else {
-			for (; lhs_it != lhs_it_e; ++lhs_it, ++it) {
-				*it = *lhs_it;
-			}
-		}
+		auto lhs_sz = lhs.size();
+		result.resize(lhs_sz + shifts + 1);
+		auto data = result.data();
+		std::fill_n(data, shifts, 0);
+		data[lhs_sz + shifts] = _lshift(data + shifts, lhs.data(), lhs_sz, shift);
 
 		// Finish up
 		result.trim();
 		return result;
 	}
 
-	static uinteger_t bitwise_lshift(const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t bitwise_lshift(const uinteger_t& lhs, std::size_t rhs) {
 		uinteger_t result;
 		bitwise_lshift(result, lhs, rhs);
 		return result;
 	}
 
-	static uinteger_t& bitwise_rshift(uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t& bitwise_lshift(uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_lshift(lhs, _shift_amount(rhs));
+	}
+
+	static uinteger_t& bitwise_lshift(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_lshift(result, lhs, _shift_amount(rhs));
+	}
+
+	static uinteger_t bitwise_lshift(const uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_lshift(lhs, _shift_amount(rhs));
+	}
+
+	static uinteger_t& bitwise_rshift(uinteger_t& lhs, std::size_t rhs) {
 		if (!rhs) {
 			return lhs;
 		}
 
-		auto lhs_sz = lhs.size();
-
 		auto _digit_bits = digit_bits;
-		if (compare(rhs, uinteger_t(lhs_sz * _digit_bits)) >= 0) {
+		auto shifts = rhs / _digit_bits;
+		auto shift = rhs % _digit_bits;
+
+		auto lhs_sz = lhs.size();
+		if (shifts >= lhs_sz) {
 			lhs = uint_0();
 			return lhs;
 		}
 
-		uinteger_t shifts_q;
-		uinteger_t shifts_r;
-		auto uint_digit_bits = uinteger_t(_digit_bits);
-		divmod(shifts_q, shifts_r, rhs, uint_digit_bits);
-		std::size_t shifts = static_cast<std::size_t>(shifts_q);
-		std::size_t shift = static_cast<std::size_t>(shifts_r);
-
-		if (shifts) {
-			lhs._begin += shifts;
-		}
-		if (shift) {
-			digit shifted = 0;
-			auto lhs_rit = lhs.rbegin();
-			auto lhs_rit_e = lhs.rend();
-			for (; lhs_rit != lhs_rit_e; ++lhs_rit) {
-				auto v = (*lhs_rit >> shift) | shifted;
-				shifted = *lhs_rit << (_digit_bits - shift);
-				*lhs_rit = v;
-			}
-			lhs.trim();
-		}
+		// Drop the low digits by moving the window, then shift the rest down
+		lhs._begin += shifts;
+		_rshift(lhs.data(), lhs.data(), lhs_sz - shifts, shift);
 
+		// Finish up
+		lhs.trim();
 		return lhs;
 	}
 
-	static uinteger_t& bitwise_rshift(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t& bitwise_rshift(uinteger_t& result, const uinteger_t& lhs, std::size_t rhs) {
 		if (&result._value == &lhs._value) {
-			bitwise_lshift(result, rhs);
+			bitwise_rshift(result, rhs);
 			return result;
 		}
 		if (!rhs) {
@@ -1205,58 +1740,43 @@ public:
 			return result;
 		}
 
-		auto lhs_sz = lhs.size();
-
 		auto _digit_bits = digit_bits;
-		if (compare(rhs, uinteger_t(lhs_sz * _digit_bits)) >= 0) {
+		auto shifts = rhs / _digit_bits;
+		auto shift = rhs % _digit_bits;
+
+		auto lhs_sz = lhs.size();
+		if (shifts >= lhs_sz) {
 			result = uint_0();
 			return result;
 		}
 
-		uinteger_t shifts_q;
-		uinteger_t shifts_r;
-		auto uint_digit_bits = uinteger_t(_digit_bits);
-		divmod(shifts_q, shifts_r, rhs, uint_digit_bits);
-		std::size_t shifts = static_cast<std::size_t>(shifts_q);
-		std::size_t shift = static_cast<std::size_t>(shifts_r);
-
 		auto result_sz = lhs_sz - shifts;
 		result.resize(result_sz);
-
-		// not using `end()` because resize of `result.resize()` could have
-		// resized `lhs` if `result` is also `lhs`.
-		auto lhs_rit = lhs.rbegin();
-		auto lhs_rit_e = lhs_rit + lhs_sz - shifts;
-
-		auto rit = result.rbegin();
-		auto rit_e = rit + result_sz;
-
-		if (shift) {
-			digit shifted = 0;
-			for (; lhs_rit != lhs_rit_e; ++lhs_rit, ++rit) {
-				ASSERT(rit != rit_e); (void)(rit_e);
-				auto v = (*lhs_rit >> shift) | shifted;
-				shifted = *lhs_rit << (_digit_bits - shift);
-				*rit = v;
-			}
-		} else {
-			for (; lhs_rit != lhs_rit_e; ++lhs_rit, ++rit) {
-				ASSERT(rit != rit_e); (void)(rit_e);
-				*rit = *lhs_rit;
-			}
-		}
+		_rshift(result.data(), lhs.data() + shifts, result_sz, shift);
 
 		// Finish up
 		result.trim();
 		return result;
 	}
 
-	static uinteger_t bitwise_rshift(const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t bitwise_rshift(const uinteger_t& lhs, std::size_t rhs) {
 		uinteger_t result;
 		bitwise_rshift(result, lhs, rhs);
 		return result;
 	}
 
+	static uinteger_t& bitwise_rshift(uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_rshift(lhs, _shift_amount(rhs));
+	}
+
+	static uinteger_t& bitwise_rshift(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_rshift(result, lhs, _shift_amount(rhs));
+	}
+
+	static uinteger_t bitwise_rshift(const uinteger_t& lhs, const uinteger_t& rhs) {
+		return bitwise_rshift(lhs, _shift_amount(rhs));
+	}
+
 	static int compare(const uinteger_t& lhs, const uinteger_t& rhs) {
 		auto lhs_sz = lhs.size();
 		auto rhs_sz = rhs.size();
@@ -1520,253 +2040,189 @@ public:
 		return result;
 	}
 
-	// Single word long multiplication
-	// Fastests, but ONLY for single sized rhs
-	static uinteger_t& single_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
-		auto lhs_sz = lhs.size();
-		auto rhs_sz = rhs.size();
-
-		ASSERT(rhs_sz == 1); (void)(rhs_sz);
-		auto n = rhs.front();
+	// Operations with a single digit
+	// These skip building a uinteger_t when the other operand is a native integer.
 
-		uinteger_t tmp;
-		tmp.resize(lhs_sz + 1, 0);
+	static int compare_1(const uinteger_t& lhs, digit rhs) {
+		return _cmp_1(lhs.data(), lhs.size(), rhs);
+	}
 
-		auto it_lhs = lhs.begin();
-		auto it_lhs_e = lhs.end();
-
-		auto it_result = tmp.begin();
-
-		digit carry = 0;
-		for (; it_lhs != it_lhs_e; ++it_lhs, ++it_result) {
-			carry = _multadd(*it_lhs, n, 0, carry, &*it_result);
-		}
-		if (carry) {
-			*it_result = carry;
+	static uinteger_t& add_1(uinteger_t& result, const uinteger_t& lhs, digit rhs) {
+		auto lhs_sz = lhs.size();
+		if (!lhs_sz) {
+			result = rhs;
+			return result;
 		}
 
-		result = std::move(tmp);
+		result.resize(lhs_sz + 1);
+		auto data = result.data();
+		data[lhs_sz] = _add_1(data, lhs.data(), lhs_sz, rhs);
+		result._carry = false;
 
 		// Finish up
 		result.trim();
 		return result;
 	}
 
-	static uinteger_t& long_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t& add_1(uinteger_t& lhs, digit rhs) {
+		// In place, the carry stops at the first digit that doesn't overflow
+		// and a new digit is only appended when it's carried out of the top.
 		auto lhs_sz = lhs.size();
-		auto rhs_sz = rhs.size();
-
-		if (lhs_sz > rhs_sz) {
-			// rhs should be the largest:
-			return long_mult(result, rhs, lhs);
-		}
-
-		if (lhs_sz == 1) {
-			return single_mult(result, rhs, lhs);
+		auto data = lhs.data();
+		if (auto carry = _add_1(data, data, lhs_sz, rhs)) {
+			lhs.append(carry);
 		}
+		lhs._carry = false;
+		return lhs;
+	}
 
-		uinteger_t tmp;
-		tmp.resize(lhs_sz + rhs_sz, 0);
-
-		auto it_lhs = lhs.begin();
-		auto it_lhs_e = lhs.end();
-
-		auto it_rhs = rhs.begin();
-		auto it_rhs_e = rhs.end();
-
-		auto it_result = tmp.begin();
-		auto it_result_s = it_result;
-		auto it_result_l = it_result;
+	static uinteger_t add_1(const uinteger_t& lhs, digit rhs) {
+		uinteger_t result;
+		add_1(result, lhs, rhs);
+		return result;
+	}
 
-		for (; it_lhs != it_lhs_e; ++it_lhs, ++it_result) {
-			if (auto lhs_it_val = *it_lhs) {
-				auto _it_rhs = it_rhs;
-				auto _it_result = it_result;
-				digit carry = 0;
-				for (; _it_rhs != it_rhs_e; ++_it_rhs, ++_it_result) {
-					carry = _multadd(*_it_rhs, lhs_it_val, *_it_result, carry, &*_it_result);
-				}
-				if (carry) {
-					*_it_result++ = carry;
-				}
-				if (it_result_l < _it_result) {
-					it_result_l = _it_result;
-				}
+	static uinteger_t& sub_1(uinteger_t& result, const uinteger_t& lhs, digit rhs) {
+		auto lhs_sz = lhs.size();
+		if (!rhs) {
+			if (&result._value != &lhs._value) {
+				result = lhs;
 			}
+			return result;
+		}
+		if (!lhs_sz) {
+			// wraps around, like sub()
+			result = static_cast<digit>(0 - rhs);
+			result._carry = true;
+			return result;
 		}
 
-		tmp.resize(it_result_l - it_result_s); // shrink
-
-		result = std::move(tmp);
+		result.resize(lhs_sz);
+		auto data = result.data();
+		result._carry = _sub_1(data, lhs.data(), lhs_sz, rhs);
 
 		// Finish up
 		result.trim();
 		return result;
 	}
 
-	// A helper for Karatsuba multiplication to split a number in two, at n.
-	static std::pair<const uinteger_t, const uinteger_t> karatsuba_mult_split(const uinteger_t& num, std::size_t n) {
-		const uinteger_t a(num, num._begin, num._begin + n);
-		const uinteger_t b(num, num._begin + n, num._end);
-		return std::make_pair(std::move(a), std::move(b));
-	}
-
-	// If rhs has at least twice the digits of lhs, and lhs is big enough that
-	// Karatsuba would pay off *if* the inputs had balanced sizes.
-	// View rhs as a sequence of slices, each with lhs.size() digits,
-	// and multiply the slices by lhs, one at a time.
-	static uinteger_t& karatsuba_lopsided_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff) {
+	static uinteger_t& sub_1(uinteger_t& lhs, digit rhs) {
+		// In place, the borrow stops at the first digit that doesn't underflow.
 		auto lhs_sz = lhs.size();
-		auto rhs_sz = rhs.size();
-
-		ASSERT(lhs_sz > cutoff);
-		ASSERT(2 * lhs_sz <= rhs_sz);
-
-		auto rhs_begin = rhs._begin;
-		std::size_t shift = 0;
-
-		uinteger_t r;
-		while (rhs_sz > 0) {
-			// Multiply the next slice of rhs by lhs and add into result:
-			auto slice_size = std::min(lhs_sz, rhs_sz);
-			const uinteger_t rhs_slice(rhs, rhs_begin, rhs_begin + slice_size);
-			uinteger_t p;
-			karatsuba_mult(p, lhs, rhs_slice, cutoff);
-			uinteger_t rs(r, shift, 0);
-			add(rs, rs, p);
-			shift += slice_size;
-			rhs_sz -= slice_size;
-			rhs_begin += slice_size;
+		if (!lhs_sz) {
+			return sub_1(lhs, lhs, rhs);
 		}
+		auto data = lhs.data();
+		lhs._carry = _sub_1(data, data, lhs_sz, rhs);
+		if (!data[lhs_sz - 1]) {
+			lhs.trim();
+		}
+		return lhs;
+	}
 
-		result = std::move(r);
+	static uinteger_t sub_1(const uinteger_t& lhs, digit rhs) {
+		uinteger_t result;
+		sub_1(result, lhs, rhs);
 		return result;
 	}
 
-	// Karatsuba multiplication
-	static uinteger_t& karatsuba_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff = 1) {
-		auto lhs_sz = lhs.size();
+	// result = lhs - rhs, for the digit lhs (result can be rhs), wrapping
+	// around like sub()
+	static uinteger_t& sub_1(uinteger_t& result, digit lhs, const uinteger_t& rhs) {
 		auto rhs_sz = rhs.size();
-
-		if (lhs_sz > rhs_sz) {
-			// rhs should be the largest:
-			return karatsuba_mult(result, rhs, lhs, cutoff);
-		}
-
-		if (lhs_sz <= cutoff) {
-			return long_mult(result, lhs, rhs);
+		if (!rhs_sz) {
+			result = lhs;
+			return result;
 		}
 
-		// If a is too small compared to b, splitting on b gives a degenerate case
-		// in which Karatsuba may be (even much) less efficient than long multiplication.
-		if (2 * lhs_sz <= rhs_sz) {
-			return karatsuba_lopsided_mult(result, lhs, rhs, cutoff);
+		result.resize(rhs_sz);
+		auto data = result.data();
+		auto rhs_data = rhs.data();
+		digit borrow = _subborrow(lhs, rhs_data[0], 0, &data[0]);
+		for (std::size_t i = 1; i < rhs_sz; ++i) {
+			borrow = _subborrow(0, rhs_data[i], borrow, &data[i]);
 		}
-
-		// Karatsuba:
-		//
-		//                  A      B
-		//               x  C      D
-		//     ---------------------
-		//                 AD     BD
-		//       AC        BC
-		//     ---------------------
-		//       AC    AD + BC    BD
-		//
-		//  AD + BC  =
-		//  AC + AD + BC + BD - AC - BD
-		//  (A + B) (C + D) - AC - BD
-
-		// Calculate the split point near the middle of the largest (rhs).
-		auto shift = rhs_sz >> 1;
-
-		// Split to get A and B:
-		const auto lhs_pair = karatsuba_mult_split(lhs, shift);
-		const auto& A = lhs_pair.second; // hi
-		const auto& B = lhs_pair.first;  // lo
-
-		// Split to get C and D:
-		const auto rhs_pair = karatsuba_mult_split(rhs, shift);
-		const auto& C = rhs_pair.second; // hi
-		const auto& D = rhs_pair.first;  // lo
-
-		// Get the pieces:
-		uinteger_t AC;
-		karatsuba_mult(AC, A, C, cutoff);
-
-		uinteger_t BD;
-		karatsuba_mult(BD, B, D, cutoff);
-		uinteger_t AD_BC, AB, CD;
-		karatsuba_mult(AD_BC, A + B, C + D, cutoff);
-		AD_BC -= AC;
-		AD_BC -= BD;
-
-		// Join the pieces, AC and BD (can't overlap) into BD:
-		BD.reserve(shift * 2 + AC.size());
-		BD.resize(shift * 2, 0);
-		BD.append(AC);
-
-		// And add AD_BC to the middle: (AC           BD) + (    AD + BC    ):
-		uinteger_t BDs(BD, shift, 0);
-		add(BDs, BDs, AD_BC);
-
-		result = std::move(BD);
+		result._carry = borrow;
 
 		// Finish up
 		result.trim();
 		return result;
 	}
 
-	static uinteger_t& mult(uinteger_t& lhs, const uinteger_t& rhs) {
-		// Hard to see how this could have a further optimized implementation.
-		return mult(lhs, lhs, rhs);
-	}
-
-	static uinteger_t& mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
-		// First try saving some calculations:
-		if (!lhs || !rhs) {
+	static uinteger_t& mult_1(uinteger_t& result, const uinteger_t& lhs, digit rhs) {
+		auto lhs_sz = lhs.size();
+		if (!lhs_sz || !rhs) {
 			result = uint_0();
 			return result;
 		}
-		if (compare(lhs, uint_1()) == 0) {
-			result = rhs;
-			return result;
-		}
-		if (compare(rhs, uint_1()) == 0) {
-			result = lhs;
-			return result;
-		}
 
-		return karatsuba_mult(result, lhs, rhs, karatsuba_cutoff);
+		result.resize(lhs_sz + 1);
+		auto data = result.data();
+		data[lhs_sz] = _mul_1(data, lhs.data(), lhs_sz, rhs);
+
+		// Finish up
+		result.trim();
+		return result;
 	}
 
-	static uinteger_t mult(const uinteger_t& lhs, const uinteger_t& rhs) {
+	static uinteger_t& mult_1(uinteger_t& lhs, digit rhs) {
+		return mult_1(lhs, lhs, rhs);
+	}
+
+	static uinteger_t mult_1(const uinteger_t& lhs, digit rhs) {
 		uinteger_t result;
-		mult(result, lhs, rhs);
+		mult_1(result, lhs, rhs);
 		return result;
 	}
 
-	// Single word long division
-	// Fastests, but ONLY for single sized rhs
-	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> single_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
-		auto lhs_sz = lhs.size();
-		auto rhs_sz = rhs.size();
+	// lhs += a b, for the digit b (a can be lhs)
+	static uinteger_t& addmul_1(uinteger_t& lhs, const uinteger_t& a, digit b) {
+		auto a_sz = a.size();
+		if (!a_sz || !b) {
+			return lhs;
+		}
+
+		auto lhs_sz = std::max(lhs.size(), a_sz) + 1;
+		lhs.resize(lhs_sz, 0);
+		auto r = lhs.data();
+		auto carry = _addmul_1(r, a.data(), a_sz, b);
+		_add_1(r + a_sz, r + a_sz, lhs_sz - a_sz, carry);
+		lhs._carry = false;
 
-		ASSERT(rhs_sz == 1); (void)(rhs_sz);
-		auto n = rhs.front();
+		// Finish up
+		lhs.trim();
+		return lhs;
+	}
+
+	// lhs -= a b, for the digit b (a can be lhs), wrapping around like sub_1()
+	static uinteger_t& submul_1(uinteger_t& lhs, const uinteger_t& a, digit b) {
+		auto a_sz = a.size();
+		if (!a_sz || !b) {
+			return lhs;
+		}
+		auto lhs_sz = lhs.size();
+		if (lhs_sz <= a_sz) {
+			return sub(lhs, mult_1(a, b));
+		}
 
-		auto rit_lhs = lhs.rbegin();
-		auto rit_lhs_e = lhs.rend();
+		auto r = lhs.data();
+		auto carry = _submul_1(r, a.data(), a_sz, b);
+		lhs._carry = _sub_1(r + a_sz, r + a_sz, lhs_sz - a_sz, carry);
 
-		auto q = uint_0();
-		q.resize(lhs_sz, 0);
-		auto rit_q = q.rbegin();
+		// Finish up
+		lhs.trim();
+		return lhs;
+	}
 
-		digit r = 0;
-		for (; rit_lhs != rit_lhs_e; ++rit_lhs, ++rit_q) {
-			r = _divmod(r, *rit_lhs, n, &*rit_q);
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> divmod_1(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, digit rhs) {
+		if (!rhs) {
+			throw std::domain_error("Error: division or modulus by 0");
 		}
 
+		auto lhs_sz = lhs.size();
+		uinteger_t q;
+		q.resize(lhs_sz);
+		auto r = _divrem_1(q.data(), lhs.data(), lhs_sz, rhs);
 		q.trim();
 
 		quotient = std::move(q);
@@ -1774,615 +2230,3964 @@ public:
 		return std::make_pair(std::ref(quotient), std::ref(remainder));
 	}
 
-	// Implementation of Knuth's Algorithm D
-	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> knuth_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
-		uinteger_t v(lhs);
-		uinteger_t w(rhs);
+	static std::pair<uinteger_t, uinteger_t> divmod_1(const uinteger_t& lhs, digit rhs) {
+		uinteger_t quotient;
+		uinteger_t remainder;
+		divmod_1(quotient, remainder, lhs, rhs);
+		return std::make_pair(std::move(quotient), std::move(remainder));
+	}
 
-		auto v_size = v.size();
-		auto w_size = w.size();
-		ASSERT(v_size >= w_size && w_size >= 2);
+	static uinteger_t& div_1(uinteger_t& lhs, digit rhs) {
+		if (!rhs) {
+			throw std::domain_error("Error: division or modulus by 0");
+		}
 
-		// D1. normalize: shift rhs left so that its top digit is >= 63 bits.
-		// shift lhs left by the same amount. Results go into w and v.
-		auto d = uinteger_t(digit_bits - _bits(w.back()));
-		v <<= d;
-		w <<= d;
+		auto data = lhs.data();
+		_divrem_1(data, data, lhs.size(), rhs);
+		lhs.trim();
+		return lhs;
+	}
 
-		if (*v.rbegin() >= *w.rbegin()) {
-			v.append(0);
+	static digit mod_1(const uinteger_t& lhs, digit rhs) {
+		if (!rhs) {
+			throw std::domain_error("Error: division or modulus by 0");
 		}
-		v_size = v.size();
-		v.append(0);
 
-		// Now *v.rbegin() < *w.rbegin() so quotient has at most
-		// (and usually exactly) k = v.size() - w.size() digits.
-		auto k = v_size - w_size;
-		auto q = uint_0();
-		q.resize(k + 1, 0);
-
-		auto rit_q = q.rend() - (k + 1);
+		return _divrem_1(nullptr, lhs.data(), lhs.size(), rhs);
+	}
 
-		auto it_v_b = v.begin();
-		auto it_v_k = it_v_b + k;
+	// Single word long multiplication
+	// Fastests, but ONLY for single sized rhs
+	static uinteger_t& single_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		ASSERT(rhs.size() == 1);
+		return mult_1(result, lhs, rhs.front());
+	}
 
-		auto it_w = w.begin();
-		auto it_w_e = w.end();
+	// Span kernels
+	// These work on raw digit spans (least significant digit first) and never
+	// allocate, outputs must not overlap inputs unless noted otherwise.
 
-		auto rit_w = w.rbegin();
-		auto wm1 = *rit_w++;
-		auto wm2 = *rit_w;
+	// r = a << shift (shift < digit_bits), returns the bits shifted out.
+	// r may overlap a as long as r >= a.
+	static digit _lshift(digit* r, const digit* a, std::size_t n, std::size_t shift) {
+		if (!shift) {
+			std::copy_backward(a, a + n, r + n);
+			return 0;
+		}
+		auto _digit_bits = digit_bits;
+		auto rshift = _digit_bits - shift;
+		digit shifted = a[n - 1] >> rshift;
+		for (auto i = n - 1; i; --i) {
+			r[i] = (a[i] << shift) | (a[i - 1] >> rshift);
+		}
+		r[0] = a[0] << shift;
+		return shifted;
+	}
 
-		// D2. inner loop: divide v[k+0..k+n] by w[0..n]
-		for (; it_v_k >= it_v_b; --it_v_k, ++rit_q) {
-			// D3. Compute estimate quotient digit q; may overestimate by 1 (rare)
-			digit _q;
-			auto _r = _divmod(*(it_v_k + w_size), *(it_v_k + w_size - 1), wm1, &_q);
-			digit mullo = 0;
-			auto mulhi = _mult(_q, wm2, &mullo);
-			auto rlo = *(it_v_k + w_size - 2);
-			while (mulhi > _r || (mulhi == _r && mullo > rlo)) {
-				--_q;
-				if (_addcarry(_r, wm1, 0, &_r)) {
-					break;
-				}
-				mulhi = _mult(_q, wm2, &mullo);
-			}
+	// r = a >> shift (shift < digit_bits), returns the bits shifted out
+	// (in the top bits). r may overlap a as long as r <= a.
+	static digit _rshift(digit* r, const digit* a, std::size_t n, std::size_t shift) {
+		if (!shift) {
+			std::copy(a, a + n, r);
+			return 0;
+		}
+		auto _digit_bits = digit_bits;
+		auto lshift = _digit_bits - shift;
+		digit shifted = a[0] << lshift;
+		for (std::size_t i = 0; i + 1 < n; ++i) {
+			r[i] = (a[i] >> shift) | (a[i + 1] << lshift);
+		}
+		r[n - 1] = a[n - 1] >> shift;
+		return shifted;
+	}
 
-			// D4. Multiply and subtract _q * w0[0:size_w] from vk[0:size_w+1]
-			auto _it_v = it_v_k;
-			auto _it_w = it_w;
-			mulhi = 0;
-			digit carry = 0;
-			for (; _it_w != it_w_e; ++_it_v, ++_it_w) {
-				mullo = 0;
-				mulhi = _multadd(*_it_w, _q, 0, mulhi, &mullo);
-				carry = _subborrow(*_it_v, mullo, carry, &*_it_v);
-			}
-			carry = _subborrow(*_it_v, 0, carry, &*_it_v);
-
-			if (carry) {
-				// D6. Add w back if q was too large (this branch taken rarely)
-				--_q;
-
-				_it_v = it_v_k;
-				_it_w = it_w;
-				carry = 0;
-				for (; _it_w != it_w_e; ++_it_v, ++_it_w) {
-					carry = _addcarry(*_it_v, *_it_w, carry, &*_it_v);
-				}
-				carry = _addcarry(*_it_v, 0, carry, &*_it_v);
+	// Compares a (an digits) and b (bn digits)
+	static int _cmp(const digit* a, std::size_t an, const digit* b, std::size_t bn) {
+		for (; an > bn; --an) {
+			if (a[an - 1]) return 1;
+		}
+		for (; bn > an; --bn) {
+			if (b[bn - 1]) return -1;
+		}
+		while (an--) {
+			if (a[an] != b[an]) {
+				return a[an] > b[an] ? 1 : -1;
 			}
-
-			/* store quotient digit */
-			*rit_q = _q;
 		}
-
-		// D8. unnormalize: unshift remainder.
-		v.resize(w_size);
-		v >>= d;
-
-		q.trim();
-		v.trim();
-
-		quotient = std::move(q);
-		remainder = std::move(v);
-		return std::make_pair(std::ref(quotient), std::ref(remainder));
+		return 0;
 	}
 
-	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
-		// First try saving some calculations:
-		if (!rhs) {
-			throw std::domain_error("Error: division or modulus by 0");
+	// r = a + b, for an >= bn, r gets an digits (r can be a), returns the carry
+	static digit _add(digit* r, const digit* a, std::size_t an, const digit* b, std::size_t bn) {
+		ASSERT(an >= bn);
+		digit carry = 0;
+		std::size_t i = 0;
+		for (; i < bn; ++i) {
+			carry = _addcarry(a[i], b[i], carry, &r[i]);
 		}
-		auto lhs_sz = lhs.size();
-		auto rhs_sz = rhs.size();
-		if (lhs_sz == 1 && rhs_sz == 1) {
-			// Fast division and modulo for single value
-			auto a = *lhs.begin();
-			auto b = *rhs.begin();
-			quotient = a / b;
-			remainder = a % b;
-			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		for (; carry && i < an; ++i) {
+			carry = _addcarry(a[i], 0, carry, &r[i]);
 		}
-		if (compare(rhs, uint_1()) == 0) {
-			quotient = lhs;
-			remainder = uint_0();
-			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		if (r != a) {
+			std::copy(a + i, a + an, r + i);
 		}
-		auto compared = compare(lhs, rhs);
-		if (compared == 0) {
-			quotient = uint_1();
-			remainder = uint_0();
-			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		return carry;
+	}
+
+	// r = a - b, for an >= bn, r gets an digits (r can be a), returns the borrow
+	static digit _sub(digit* r, const digit* a, std::size_t an, const digit* b, std::size_t bn) {
+		ASSERT(an >= bn);
+		digit borrow = 0;
+		std::size_t i = 0;
+		for (; i < bn; ++i) {
+			borrow = _subborrow(a[i], b[i], borrow, &r[i]);
 		}
-		if (!lhs || compared < 0) {
-			quotient = uint_0();
-			remainder = lhs;
-			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		for (; borrow && i < an; ++i) {
+			borrow = _subborrow(a[i], 0, borrow, &r[i]);
 		}
-		if (rhs_sz == 1) {
-			return single_divmod(quotient, remainder, lhs, rhs);
+		if (r != a) {
+			std::copy(a + i, a + an, r + i);
 		}
+		return borrow;
+	}
 
-		return knuth_divmod(quotient, remainder, lhs, rhs);
+	// Compares a (an digits) and the digit b
+	static int _cmp_1(const digit* a, std::size_t an, digit b) {
+		for (; an > 1; --an) {
+			if (a[an - 1]) return 1;
+		}
+		auto x = an ? a[0] : 0;
+		if (x != b) {
+			return x > b ? 1 : -1;
+		}
+		return 0;
 	}
 
-	static std::pair<uinteger_t, uinteger_t> divmod(const uinteger_t& lhs, const uinteger_t& rhs) {
-		uinteger_t quotient;
-		uinteger_t remainder;
-		divmod(quotient, remainder, lhs, rhs);
-		return std::make_pair(std::move(quotient), std::move(remainder));
+	// r = a + b, for the digit b, r gets an digits (r can be a), returns the carry
+	static digit _add_1(digit* r, const digit* a, std::size_t an, digit b) {
+		digit carry = b;
+		std::size_t i = 0;
+		for (; carry && i < an; ++i) {
+			carry = _addcarry(a[i], carry, 0, &r[i]);
+		}
+		if (r != a) {
+			std::copy(a + i, a + an, r + i);
+		}
+		return carry;
 	}
 
-private:
-	// Constructors
+	// r = a - b, for the digit b, r gets an digits (r can be a), returns the borrow
+	static digit _sub_1(digit* r, const digit* a, std::size_t an, digit b) {
+		digit borrow = b;
+		std::size_t i = 0;
+		for (; borrow && i < an; ++i) {
+			borrow = _subborrow(a[i], borrow, 0, &r[i]);
+		}
+		if (r != a) {
+			std::copy(a + i, a + an, r + i);
+		}
+		return borrow;
+	}
 
-	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-	void _uint_t(const T& value) {
-		append(static_cast<digit>(value));
+	// r = a b, for the digit b, r gets an digits (r can be a), returns the carry (a digit)
+	static digit _mul_1(digit* r, const digit* a, std::size_t an, digit b) {
+		digit carry = 0;
+		for (std::size_t i = 0; i < an; ++i) {
+			carry = _multadd(a[i], b, 0, carry, &r[i]);
+		}
+		return carry;
 	}
 
-	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-	void _uint_t(const T& value, Args... args) {
-		_uint_t(args...);
-		append(static_cast<digit>(value));
+	// r = r + a b, for an digit a, returns the carry (a digit)
+	static digit _addmul_1(digit* r, const digit* a, std::size_t an, digit b) {
+		digit carry = 0;
+		for (std::size_t i = 0; i < an; ++i) {
+			carry = _multadd(a[i], b, r[i], carry, &r[i]);
+		}
+		return carry;
 	}
 
-	// This constructor creates a window view of the _value
-	uinteger_t(const uinteger_t& o, std::size_t begin, std::size_t end) :
-		_begin(begin),
+	// r = r - a b, for an digit a, returns the borrow (a digit)
+	static digit _submul_1(digit* r, const digit* a, std::size_t an, digit b) {
+		digit carry = 0;
+		for (std::size_t i = 0; i < an; ++i) {
+			digit lo;
+			carry = _multadd(a[i], b, 0, carry, &lo);
+			carry += _subborrow(r[i], lo, 0, &r[i]);
+		}
+		return carry;
+	}
+
+	// r = a * b, r gets an + bn digits
+	static void _long_mult(digit* r, const digit* a, std::size_t an, const digit* b, std::size_t bn) {
+		std::fill_n(r, bn, 0);
+		for (std::size_t i = 0; i < an; ++i) {
+			auto _r = r + i;
+			digit carry = 0;
+			if (auto a_val = a[i]) {
+				for (std::size_t j = 0; j < bn; ++j) {
+					carry = _multadd(b[j], a_val, _r[j], carry, &_r[j]);
+				}
+			}
+			_r[bn] = carry;
+		}
+	}
+
+	// r = a * b mod 2^(digit_bits t), r gets t digits (the low part of the product)
+	static void _long_mult_lo(digit* r, const digit* a, std::size_t an, const digit* b, std::size_t bn, std::size_t t) {
+		std::fill_n(r, t, 0);
+		for (std::size_t i = 0; i < an && i < t; ++i) {
+			auto len = std::min(bn, t - i);
+			auto carry = _addmul_1(r + i, b, len, a[i]);
+			_add_1(r + i + len, r + i + len, t - i - len, carry);
+		}
+	}
+
+	// r = a * a, r gets 2 n digits
+	// Computes each off-diagonal product a[i] a[j] (i < j) once, doubles
+	// them and then adds the diagonal squares a[i]^2.
+	static void _long_sqr(digit* r, const digit* a, std::size_t n) {
+		std::fill_n(r, 2 * n, 0);
+
+		// Off-diagonal products:
+		for (std::size_t i = 0; i < n; ++i) {
+			if (auto a_val = a[i]) {
+				auto _r = r + i;
+				digit carry = 0;
+				for (std::size_t j = i + 1; j < n; ++j) {
+					carry = _multadd(a[j], a_val, _r[j], carry, &_r[j]);
+				}
+				_r[n] = carry;
+			}
+		}
+
+		// Double them and add the diagonal:
+		digit shifted = 0;
+		digit carry = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			digit lo;
+			auto hi = _mult(a[i], a[i], &lo);
+			auto r0 = r[2 * i];
+			auto r1 = r[2 * i + 1];
+			carry = _addcarry(static_cast<digit>(r0 << 1) | shifted, lo, carry, &r[2 * i]);
+			carry = _addcarry(static_cast<digit>(r1 << 1) | static_cast<digit>(r0 >> (digit_bits - 1)), hi, carry, &r[2 * i + 1]);
+			shifted = r1 >> (digit_bits - 1);
+		}
+		ASSERT(!carry && !shifted);
+	}
+
+	// Number of scratch digits needed by _karatsuba_mult()
+	// (follows the same recursion, but only depends on the sizes).
+	static std::size_t _karatsuba_scratch(std::size_t an, std::size_t bn, std::size_t cutoff) {
+		if (an > bn) {
+			std::swap(an, bn);
+		}
+		if (an <= cutoff) {
+			return 0;
+		}
+		auto h = (bn + 1) / 2;
+		if (an <= h) {
+			auto s = _karatsuba_scratch(an, an, cutoff);
+			if (auto rest = bn % an) {
+				s = std::max(s, _karatsuba_scratch(an, rest, cutoff));
+			}
+			return 2 * an + s;
+		}
+		return std::max(_karatsuba_scratch(an - h, bn - h, cutoff), 4 * h + 2 + _karatsuba_scratch(h, h, cutoff));
+	}
+
+	// Karatsuba multiplication of spans
+	// r = a * b, r gets an + bn digits, scratch needs _karatsuba_scratch(an, bn, cutoff) digits.
+	static void _karatsuba_mult(digit* r, const digit* a, std::size_t an, const digit* b, std::size_t bn, digit* scratch, std::size_t cutoff) {
+		if (an > bn) {
+			// b should be the largest:
+			std::swap(a, b);
+			std::swap(an, bn);
+		}
+
+		if (an <= cutoff) {
+			_long_mult(r, a, an, b, bn);
+			return;
+		}
+
+		// Split b near the middle, low halves get h digits:
+		auto h = (bn + 1) / 2;
+
+		if (an <= h) {
+			// If a is too small compared to b, splitting on b gives a degenerate case
+			// in which Karatsuba may be (even much) less efficient than long multiplication.
+			// View b as a sequence of slices, each with an digits,
+			// and multiply the slices by a, one at a time.
+			_karatsuba_mult(r, a, an, b, an, scratch, cutoff);
+			auto p = scratch;
+			for (std::size_t shift = an; shift < bn; shift += an) {
+				auto slice_size = std::min(an, bn - shift);
+				_karatsuba_mult(p, a, an, b + shift, slice_size, p + 2 * an, cutoff);
+				// r[shift, shift + an) has the high part of the previous product:
+				auto carry = _add(r + shift, p, an + slice_size, r + shift, an);
+				ASSERT(!carry); (void)(carry);
+			}
+			return;
+		}
+
+		// Karatsuba:
+		//
+		//                  A      B
+		//               x  C      D
+		//     ---------------------
+		//                 AD     BD
+		//       AC        BC
+		//     ---------------------
+		//       AC    AD + BC    BD
+		//
+		//  AD + BC  =
+		//  AC + AD + BC + BD - AC - BD
+		//  (A + B) (C + D) - AC - BD
+
+		auto a1n = an - h;
+		auto b1n = bn - h;
+
+		// BD and AC go straight into r (they can't overlap):
+		_karatsuba_mult(r, a, h, b, h, scratch, cutoff);
+		_karatsuba_mult(r + 2 * h, a + h, a1n, b + h, b1n, scratch, cutoff);
+
+		// (A + B) (C + D), with h digit sums and their carries handled apart:
+		auto AB = scratch;
+		auto CD = AB + h;
+		auto AD_BC = CD + h;
+		auto AB_carry = _add(AB, a, h, a + h, a1n);
+		auto CD_carry = _add(CD, b, h, b + h, b1n);
+		_karatsuba_mult(AD_BC, AB, h, CD, h, AD_BC + 2 * h + 2, cutoff);
+		AD_BC[2 * h] = 0;
+		AD_BC[2 * h + 1] = 0;
+		if (AB_carry) {
+			_add(AD_BC + h, AD_BC + h, h + 2, CD, h);
+		}
+		if (CD_carry) {
+			_add(AD_BC + h, AD_BC + h, h + 2, AB, h);
+		}
+		if (AB_carry && CD_carry) {
+			_add(AD_BC + 2 * h, AD_BC + 2 * h, 2, &AB_carry, 1);
+		}
+
+		// AD + BC = (A + B) (C + D) - AC - BD:
+		_sub(AD_BC, AD_BC, 2 * h + 2, r, 2 * h);
+		_sub(AD_BC, AD_BC, 2 * h + 2, r + 2 * h, a1n + b1n);
+
+		// And add AD_BC to the middle: (AC           BD) + (    AD + BC    ):
+		auto AD_BC_sz = std::min(2 * h + 2, an + bn - h);
+		ASSERT(!_cmp(AD_BC + AD_BC_sz, 2 * h + 2 - AD_BC_sz, nullptr, 0));
+		auto carry = _add(r + h, r + h, an + bn - h, AD_BC, AD_BC_sz);
+		ASSERT(!carry); (void)(carry);
+	}
+
+	// Number of scratch digits needed by _karatsuba_sqr()
+	static std::size_t _karatsuba_sqr_scratch(std::size_t n, std::size_t cutoff) {
+		std::size_t s = 0;
+		for (; n > cutoff; n = (n + 1) / 2) {
+			s += 5 * ((n + 1) / 2) + 1;
+		}
+		return s;
+	}
+
+	// Karatsuba squaring of spans
+	//
+	//  (A x + B)^2  =  A^2 x^2 + 2 A B x + B^2
+	//  2 A B  =  A^2 + B^2 - (A - B)^2
+	//
+	// r = a * a, r gets 2 n digits, scratch needs _karatsuba_sqr_scratch(n, cutoff) digits.
+	static void _karatsuba_sqr(digit* r, const digit* a, std::size_t n, digit* scratch, std::size_t cutoff) {
+		if (n <= cutoff) {
+			_long_sqr(r, a, n);
+			return;
+		}
+
+		auto h = (n + 1) / 2;
+		auto a1n = n - h;
+
+		// B^2 and A^2 go straight into r (they can't overlap):
+		_karatsuba_sqr(r, a, h, scratch, cutoff);
+		_karatsuba_sqr(r + 2 * h, a + h, a1n, scratch, cutoff);
+
+		// (A - B)^2:
+		auto AB = scratch;
+		auto AB2 = AB + h;
+		auto AB_2 = AB2 + 2 * h;
+		if (_cmp(a, h, a + h, a1n) >= 0) {
+			_sub(AB, a, h, a + h, a1n);
+		} else {
+			_sub(AB, a + h, a1n, a, a1n);
+			std::fill(AB + a1n, AB + h, 0);
+		}
+		_karatsuba_sqr(AB2, AB, h, AB_2 + 2 * h + 1, cutoff);
+
+		// 2 A B = A^2 + B^2 - (A - B)^2:
+		AB_2[2 * h] = _add(AB_2, r, 2 * h, r + 2 * h, 2 * a1n);
+		auto borrow = _sub(AB_2, AB_2, 2 * h + 1, AB2, 2 * h);
+		ASSERT(!borrow); (void)(borrow);
+
+		// And add 2 A B to the middle:
+		auto AB_2_sz = std::min(2 * h + 1, 2 * n - h);
+		ASSERT(!_cmp(AB_2 + AB_2_sz, 2 * h + 1 - AB_2_sz, nullptr, 0));
+		auto carry = _add(r + h, r + h, 2 * n - h, AB_2, AB_2_sz);
+		ASSERT(!carry); (void)(carry);
+	}
+
+	// -m^-1 mod 2^digit_bits, for the odd digit m (Newton iteration, each
+	// step doubles the number of correct low bits)
+	static digit _montgomery_inverse(digit m) {
+		digit inv = m;  // correct to 3 bits, since m m = 1 (mod 8)
+		for (std::size_t bits = 3; bits < digit_bits; bits *= 2) {
+			inv *= static_cast<digit>(2 - m * inv);
+		}
+		return static_cast<digit>(0 - inv);
+	}
+
+	// r = t - m if t (n digits plus the top digit) >= m, or t otherwise (r can be t)
+	static void _montgomery_finish(digit* r, const digit* t, digit top, const digit* m, std::size_t n) {
+		if (top || _cmp(t, n, m, n) >= 0) {
+			_sub(r, t, n, m, n);
+		} else if (r != t) {
+			std::copy(t, t + n, r);
+		}
+	}
+
+	// Montgomery reduction (REDC), for t < m R (with R = 2^(digit_bits n)):
+	// r = t R^-1 mod m, r gets n digits, t has 2 n digits and is overwritten.
+	static void _montgomery_reduce(digit* r, digit* t, const digit* m, std::size_t n, digit m_inv) {
+		digit top = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			// adding a multiple of m clears t[i]
+			auto carry = _addmul_1(t + i, m, n, static_cast<digit>(t[i] * m_inv));
+			top += _add_1(t + i + n, t + i + n, n - i, carry);
+		}
+		_montgomery_finish(r, t + n, top, m, n);
+	}
+
+	// Montgomery multiplication (CIOS, interleaving the product and the
+	// reduction one digit of b at a time), for a, b < m:
+	// r = a b R^-1 mod m, r gets n digits (r can be a or b), t needs n + 2 digits.
+	static void _montgomery_mult(digit* r, const digit* a, const digit* b, const digit* m, std::size_t n, digit m_inv, digit* t) {
+		std::fill_n(t, n + 2, 0);
+		for (std::size_t i = 0; i < n; ++i) {
+			// t += a b[i]
+			auto carry = _addmul_1(t, a, n, b[i]);
+			t[n + 1] = _addcarry(t[n], carry, 0, &t[n]);
+
+			// t = (t + u m) / 2^digit_bits, u being chosen so that the division is exact
+			auto u = static_cast<digit>(t[0] * m_inv);
+			digit lo;
+			carry = _multadd(u, m[0], t[0], 0, &lo);
+			for (std::size_t j = 1; j < n; ++j) {
+				carry = _multadd(u, m[j], t[j], carry, &t[j - 1]);
+			}
+			carry = _addcarry(t[n], carry, 0, &t[n - 1]);
+			t[n] = t[n + 1] + carry;
+		}
+		_montgomery_finish(r, t, t[n], m, n);
+	}
+
+	// Montgomery squaring (SOS, the full square followed by the reduction), for a < m:
+	// r = a^2 R^-1 mod m, r gets n digits (r can be a), t needs _montgomery_scratch(n) digits.
+	static void _montgomery_sqr(digit* r, const digit* a, const digit* m, std::size_t n, digit m_inv, digit* t) {
+		_karatsuba_sqr(t, a, n, t + 2 * n, karatsuba_cutoff);
+		_montgomery_reduce(r, t, m, n, m_inv);
+	}
+
+	// Number of scratch digits needed by the Montgomery kernels
+	static std::size_t _montgomery_scratch(std::size_t n) {
+		return std::max(n + 2, 2 * n + _karatsuba_sqr_scratch(n, karatsuba_cutoff));
+	}
+
+	static uinteger_t& long_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		if (lhs_sz > rhs_sz) {
+			// rhs should be the largest:
+			return long_mult(result, rhs, lhs);
+		}
+
+		if (lhs_sz == 1) {
+			return single_mult(result, rhs, lhs);
+		}
+
+		uinteger_t tmp;
+		tmp.resize(lhs_sz + rhs_sz);
+		_long_mult(tmp.data(), lhs.data(), lhs_sz, rhs.data(), rhs_sz);
+
+		result = std::move(tmp);
+
+		// Finish up
+		result.trim();
+		return result;
+	}
+
+	// Long squaring
+	static uinteger_t& long_sqr(uinteger_t& result, const uinteger_t& num) {
+		auto num_sz = num.size();
+
+		if (num_sz == 1) {
+			return single_mult(result, num, num);
+		}
+
+		uinteger_t tmp;
+		tmp.resize(2 * num_sz);
+		_long_sqr(tmp.data(), num.data(), num_sz);
+
+		result = std::move(tmp);
+
+		// Finish up
+		result.trim();
+		return result;
+	}
+
+	// Karatsuba multiplication
+	// All intermediate values live in a single scratch buffer, sized up front,
+	// so there are no allocations in the recursion.
+	static uinteger_t& karatsuba_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff = 1) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		if (lhs_sz > rhs_sz) {
+			// rhs should be the largest:
+			return karatsuba_mult(result, rhs, lhs, cutoff);
+		}
+
+		cutoff = std::max(cutoff, static_cast<std::size_t>(1));
+		if (lhs_sz <= cutoff) {
+			return long_mult(result, lhs, rhs);
+		}
+
+		uinteger_t tmp;
+		tmp.resize(lhs_sz + rhs_sz);
+		container scratch;
+		scratch.resize(_karatsuba_scratch(lhs_sz, rhs_sz, cutoff));
+		_karatsuba_mult(tmp.data(), lhs.data(), lhs_sz, rhs.data(), rhs_sz, scratch.data(), cutoff);
+
+		result = std::move(tmp);
+
+		// Finish up
+		result.trim();
+		return result;
+	}
+
+	// Karatsuba squaring
+	static uinteger_t& karatsuba_sqr(uinteger_t& result, const uinteger_t& num, std::size_t cutoff = 1) {
+		auto num_sz = num.size();
+
+		cutoff = std::max(cutoff, static_cast<std::size_t>(1));
+		if (num_sz <= cutoff) {
+			return long_sqr(result, num);
+		}
+
+		uinteger_t tmp;
+		tmp.resize(2 * num_sz);
+		container scratch;
+		scratch.resize(_karatsuba_sqr_scratch(num_sz, cutoff));
+		_karatsuba_sqr(tmp.data(), num.data(), num_sz, scratch.data(), cutoff);
+
+		result = std::move(tmp);
+
+		// Finish up
+		result.trim();
+		return result;
+	}
+
+	// A helper for Toom-Cook multiplication to get a trimmed copy of the
+	// digits [from, to) of a number (digits past its end are zeros).
+	static uinteger_t toom_split(const uinteger_t& num, std::size_t from, std::size_t to) {
+		auto num_sz = num.size();
+		from = std::min(from, num_sz);
+		to = std::min(to, num_sz);
+		uinteger_t result;
+		result.resize(to - from);
+		std::copy(num.begin() + from, num.begin() + to, result.begin());
+		result.trim();
+		return result;
+	}
+
+	// Adds num, shifted by `shift` digits, to lhs.
+	static uinteger_t& add_shifted(uinteger_t& lhs, const uinteger_t& num, std::size_t shift) {
+		auto num_sz = num.size();
+		if (!num_sz) {
+			return lhs;
+		}
+		auto lhs_sz = lhs.size();
+		if (lhs_sz < shift + num_sz) {
+			lhs.resize(shift + num_sz, 0); // grow
+			lhs_sz = shift + num_sz;
+		}
+
+		auto it = lhs.begin() + shift;
+		auto it_e = lhs.begin() + lhs_sz;
+
+		auto num_it = num.begin();
+		auto num_it_e = num.end();
+
+		digit carry = 0;
+		for (; num_it != num_it_e; ++num_it, ++it) {
+			carry = _addcarry(*it, *num_it, carry, &*it);
+		}
+		for (; carry && it != it_e; ++it) {
+			carry = _addcarry(*it, 0, carry, &*it);
+		}
+		if (carry) {
+			lhs.append(1);
+		}
+
+		// Finish up
+		lhs.trim();
+		return lhs;
+	}
+
+	// Signed addition for the evaluation and interpolation steps of Toom-Cook
+	// multiplication (values are kept as magnitude and sign).
+	static uinteger_t& toom_signed_add(uinteger_t& lhs, bool& lhs_negative, const uinteger_t& rhs, bool rhs_negative) {
+		if (lhs_negative == rhs_negative) {
+			add(lhs, rhs);
+		} else if (compare(lhs, rhs) >= 0) {
+			sub(lhs, rhs);
+		} else {
+			lhs = sub(rhs, lhs);
+			lhs_negative = rhs_negative;
+		}
+		if (!lhs) {
+			lhs_negative = false;
+		}
+		return lhs;
+	}
+
+	static uinteger_t& toom_signed_sub(uinteger_t& lhs, bool& lhs_negative, const uinteger_t& rhs, bool rhs_negative) {
+		return toom_signed_add(lhs, lhs_negative, rhs, !rhs_negative);
+	}
+
+	// Interpolation and recomposition of the five pointwise products of Toom-3
+	// (evaluated at 0, 1, -1, -2 and infinity) into result.
+	static uinteger_t& toom33_interpolate(uinteger_t& result, uinteger_t& r0, uinteger_t& r1, uinteger_t& rm1, bool rm1_negative, uinteger_t& rm2, bool rm2_negative, uinteger_t& rinf, std::size_t k, std::size_t sz) {
+		// Interpolation:
+		//   r3 = (r(-2) - r(1)) / 3
+		//   r1 = (r(1) - r(-1)) / 2
+		//   r2 = r(-1) - r(0)
+		//   r3 = (r2 - r3) / 2 + 2 r(inf)
+		//   r2 = r2 + r1 - r(inf)
+		//   r1 = r1 - r3
+		auto& r3 = rm2;
+		bool r3_negative = rm2_negative;
+		toom_signed_sub(r3, r3_negative, r1, false);
+		uinteger_t r3_remainder;
+		single_divmod(r3, r3_remainder, r3, uinteger_t(3));
+		ASSERT(!r3_remainder);
+
+		bool r1_negative = false;
+		toom_signed_sub(r1, r1_negative, rm1, rm1_negative);
+		r1 >>= 1;
+
+		auto& r2 = rm1;
+		bool r2_negative = rm1_negative;
+		toom_signed_sub(r2, r2_negative, r0, false);
+
+		uinteger_t t = r2;
+		bool t_negative = r2_negative;
+		toom_signed_sub(t, t_negative, r3, r3_negative);
+		t >>= 1;
+		toom_signed_add(t, t_negative, rinf << 1, false);
+		r3 = std::move(t);
+		r3_negative = t_negative;
+
+		toom_signed_add(r2, r2_negative, r1, r1_negative);
+		toom_signed_sub(r2, r2_negative, rinf, false);
+
+		toom_signed_sub(r1, r1_negative, r3, r3_negative);
+
+		ASSERT(!r1_negative && !r2_negative && !r3_negative);
+
+		// Recomposition:
+		uinteger_t tmp(std::move(r0));
+		tmp.reserve(sz + 1);
+		add_shifted(tmp, r1, k);
+		add_shifted(tmp, r2, 2 * k);
+		add_shifted(tmp, r3, 3 * k);
+		add_shifted(tmp, rinf, 4 * k);
+
+		result = std::move(tmp);
+		return result;
+	}
+
+	// Toom-3 multiplication (balanced operands)
+	static uinteger_t& toom33_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		// Toom-3 (evaluating at 0, 1, -1, -2 and infinity):
+		//
+		//   lhs = a2 x^2 + a1 x + a0
+		//   rhs = b2 x^2 + b1 x + b0     (x = 2^(digit_bits * k))
+		//
+		// The product is a polynomial of degree 4 which is found by
+		// interpolating the five pointwise products using Bodrato's sequence.
+
+		auto k = (std::max(lhs_sz, rhs_sz) + 2) / 3;
+
+		auto a0 = toom_split(lhs, 0, k);
+		auto a1 = toom_split(lhs, k, 2 * k);
+		auto a2 = toom_split(lhs, 2 * k, lhs_sz);
+
+		auto b0 = toom_split(rhs, 0, k);
+		auto b1 = toom_split(rhs, k, 2 * k);
+		auto b2 = toom_split(rhs, 2 * k, rhs_sz);
+
+		// Evaluation:
+		//   p(1) = a0 + a1 + a2, p(-1) = a0 - a1 + a2, p(-2) = (p(-1) + a2) * 2 - a0
+		auto pm1 = a0 + a2;
+		auto p1 = pm1 + a1;
+		bool pm1_negative = false;
+		toom_signed_sub(pm1, pm1_negative, a1, false);
+		auto pm2 = pm1;
+		bool pm2_negative = pm1_negative;
+		toom_signed_add(pm2, pm2_negative, a2, false);
+		pm2 <<= 1;
+		toom_signed_sub(pm2, pm2_negative, a0, false);
+
+		auto qm1 = b0 + b2;
+		auto q1 = qm1 + b1;
+		bool qm1_negative = false;
+		toom_signed_sub(qm1, qm1_negative, b1, false);
+		auto qm2 = qm1;
+		bool qm2_negative = qm1_negative;
+		toom_signed_add(qm2, qm2_negative, b2, false);
+		qm2 <<= 1;
+		toom_signed_sub(qm2, qm2_negative, b0, false);
+
+		// Pointwise multiplication:
+		uinteger_t r0, r1, rm1, rm2, rinf;
+		mult(r0, a0, b0);
+		mult(r1, p1, q1);
+		mult(rm1, pm1, qm1);
+		bool rm1_negative = pm1_negative != qm1_negative && rm1;
+		mult(rm2, pm2, qm2);
+		bool rm2_negative = pm2_negative != qm2_negative && rm2;
+		mult(rinf, a2, b2);
+
+		return toom33_interpolate(result, r0, r1, rm1, rm1_negative, rm2, rm2_negative, rinf, k, lhs_sz + rhs_sz);
+	}
+
+	// Toom-3 squaring
+	// Same evaluation points as toom33_mult, but evaluates a single operand
+	// and the pointwise products are squares (so all of them are positive).
+	static uinteger_t& toom33_sqr(uinteger_t& result, const uinteger_t& num) {
+		auto num_sz = num.size();
+
+		auto k = (num_sz + 2) / 3;
+
+		auto a0 = toom_split(num, 0, k);
+		auto a1 = toom_split(num, k, 2 * k);
+		auto a2 = toom_split(num, 2 * k, num_sz);
+
+		// Evaluation:
+		auto pm1 = a0 + a2;
+		auto p1 = pm1 + a1;
+		bool pm1_negative = false;
+		toom_signed_sub(pm1, pm1_negative, a1, false);
+		auto pm2 = pm1;
+		bool pm2_negative = pm1_negative;
+		toom_signed_add(pm2, pm2_negative, a2, false);
+		pm2 <<= 1;
+		toom_signed_sub(pm2, pm2_negative, a0, false);
+
+		// Pointwise squaring:
+		uinteger_t r0, r1, rm1, rm2, rinf;
+		sqr(r0, a0);
+		sqr(r1, p1);
+		sqr(rm1, pm1);
+		sqr(rm2, pm2);
+		sqr(rinf, a2);
+
+		return toom33_interpolate(result, r0, r1, rm1, false, rm2, false, rinf, k, 2 * num_sz);
+	}
+
+	// Toom-3/2 multiplication (lhs has around two thirds the digits of rhs)
+	static uinteger_t& toom32_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		// Toom-3/2 (evaluating at 0, 1, -1 and infinity):
+		//
+		//   rhs = a2 x^2 + a1 x + a0
+		//   lhs =          b1 x + b0
+		//
+		//   c0 = r(0)
+		//   c1 = (r(1) - r(-1)) / 2 - r(inf)
+		//   c2 = (r(1) + r(-1)) / 2 - r(0)
+		//   c3 = r(inf)
+
+		auto k = std::max((rhs_sz + 2) / 3, (lhs_sz + 1) / 2);
+
+		auto a0 = toom_split(rhs, 0, k);
+		auto a1 = toom_split(rhs, k, 2 * k);
+		auto a2 = toom_split(rhs, 2 * k, rhs_sz);
+
+		auto b0 = toom_split(lhs, 0, k);
+		auto b1 = toom_split(lhs, k, lhs_sz);
+
+		auto pm1 = a0 + a2;
+		auto p1 = pm1 + a1;
+		bool pm1_negative = false;
+		toom_signed_sub(pm1, pm1_negative, a1, false);
+
+		auto q1 = b0 + b1;
+		auto qm1 = b0;
+		bool qm1_negative = false;
+		toom_signed_sub(qm1, qm1_negative, b1, false);
+
+		uinteger_t r0, r1, rm1, rinf;
+		mult(r0, a0, b0);
+		mult(r1, p1, q1);
+		mult(rm1, pm1, qm1);
+		bool rm1_negative = pm1_negative != qm1_negative && rm1;
+		mult(rinf, a2, b1);
+
+		uinteger_t c1 = r1;
+		bool c1_negative = false;
+		toom_signed_sub(c1, c1_negative, rm1, rm1_negative);
+		c1 >>= 1;
+		toom_signed_sub(c1, c1_negative, rinf, false);
+
+		auto& c2 = r1;
+		bool c2_negative = false;
+		toom_signed_add(c2, c2_negative, rm1, rm1_negative);
+		c2 >>= 1;
+		toom_signed_sub(c2, c2_negative, r0, false);
+
+		ASSERT(!c1_negative && !c2_negative);
+
+		uinteger_t tmp(std::move(r0));
+		tmp.reserve(lhs_sz + rhs_sz + 1);
+		add_shifted(tmp, c1, k);
+		add_shifted(tmp, c2, 2 * k);
+		add_shifted(tmp, rinf, 3 * k);
+
+		result = std::move(tmp);
+		return result;
+	}
+
+	// Toom-Cook multiplication
+	// Uses Toom-3 for balanced operands, Toom-3/2 for mildly unbalanced ones
+	// and multiplies slices of rhs by lhs for very lopsided ones.
+	static uinteger_t& toom3_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff = toom3_cutoff) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		if (lhs_sz > rhs_sz) {
+			// rhs should be the largest:
+			return toom3_mult(result, rhs, lhs, cutoff);
+		}
+
+		if (lhs_sz < cutoff) {
+			return karatsuba_mult(result, lhs, rhs, karatsuba_cutoff);
+		}
+
+		if (2 * lhs_sz <= rhs_sz) {
+			// View rhs as a sequence of slices, each with lhs.size() digits,
+			// and multiply the slices by lhs, one at a time.
+			uinteger_t r;
+			r.reserve(lhs_sz + rhs_sz + 1);
+			std::size_t shift = 0;
+			while (shift < rhs_sz) {
+				auto slice_size = std::min(lhs_sz, rhs_sz - shift);
+				auto rhs_slice = toom_split(rhs, shift, shift + slice_size);
+				uinteger_t p;
+				mult(p, lhs, rhs_slice);
+				add_shifted(r, p, shift);
+				shift += slice_size;
+			}
+			result = std::move(r);
+			return result;
+		}
+
+		if (3 * rhs_sz > 4 * lhs_sz) {
+			return toom32_mult(result, lhs, rhs);
+		}
+
+		return toom33_mult(result, lhs, rhs);
+	}
+
+	// Toom-Cook squaring
+	static uinteger_t& toom3_sqr(uinteger_t& result, const uinteger_t& num, std::size_t cutoff = toom3_cutoff) {
+		if (num.size() < cutoff) {
+			return karatsuba_sqr(result, num, karatsuba_cutoff);
+		}
+
+		return toom33_sqr(result, num);
+	}
+
+	// Number-theoretic transform multiplication
+	// Digits are convolved modulo three primes p = k 2^50 + 1 (just above 2^62)
+	// using Montgomery arithmetic and the exact coefficients are recovered with
+	// the Chinese remainder theorem. As p1 p2 p3 > 2^186 > n (2^64)^2, results
+	// are exact for any transform length n up to 2^50 (no floating point).
+
+	struct ntt_prime {
+		digit p;     // prime modulus
+		digit pinv;  // -p^-1 mod 2^digit_bits
+		digit r2;    // 2^(2 digit_bits) mod p
+		digit one;   // 2^digit_bits mod p (one in Montgomery form)
+		digit g;     // primitive root (in Montgomery form)
+
+		ntt_prime(digit prime, digit root) :
+			p(prime) {
+			// Newton iterations for the inverse modulo 2^digit_bits
+			digit inv = p;
+			for (int i = 0; i < 6; ++i) {
+				inv *= 2 - p * inv;
+			}
+			pinv = -inv;
+			one = (0 - p) % p;
+			r2 = one;
+			for (std::size_t i = 0; i < digit_bits; ++i) {
+				r2 = add(r2, r2);
+			}
+			g = mont_mult(root, r2);
+		}
+
+		digit add(digit x, digit y) const {
+			auto r = x + y;
+			return r >= p ? r - p : r;
+		}
+
+		digit sub(digit x, digit y) const {
+			return x >= y ? x - y : x + p - y;
+		}
+
+		// Montgomery multiplication: x y 2^-digit_bits mod p
+		// (x y must be less than p 2^digit_bits)
+		digit mont_mult(digit x, digit y) const {
+			digit lo;
+			auto hi = _mult(x, y, &lo);
+			digit m = lo * pinv;
+			digit mlo;
+			auto mhi = _mult(m, p, &mlo);
+			auto carry = _addcarry(lo, mlo, 0, &mlo);
+			auto r = hi + mhi + carry;
+			return r >= p ? r - p : r;
+		}
+
+		digit mont_pow(digit x, std::size_t e) const {
+			auto r = one;
+			for (; e; e >>= 1) {
+				if (e & 1) {
+					r = mont_mult(r, x);
+				}
+				x = mont_mult(x, x);
+			}
+			return r;
+		}
+	};
+
+	static const ntt_prime& ntt_primes(std::size_t idx) {
+		static const ntt_prime primes[3] = {
+			ntt_prime(static_cast<digit>(0x400c000000000001ULL), 3),
+			ntt_prime(static_cast<digit>(0x42f4000000000001ULL), 3),
+			ntt_prime(static_cast<digit>(0x442c000000000001ULL), 3),
+		};
+		return primes[idx];
+	}
+
+	// Powers of the primitive n-th root of unity (or of its inverse), in Montgomery form
+	static void ntt_roots(container& roots, std::size_t n, const ntt_prime& m, bool inverse) {
+		auto w = m.mont_pow(m.g, (m.p - 1) / n);
+		if (inverse) {
+			w = m.mont_pow(w, n - 1);
+		}
+		roots.resize(n / 2);
+		auto it = roots.begin();
+		auto it_e = roots.end();
+		for (auto r = m.one; it != it_e; ++it) {
+			*it = r;
+			r = m.mont_mult(r, w);
+		}
+	}
+
+	// Forward transform (decimation in frequency, natural order in, bit-reversed order out)
+	static void ntt_forward(digit* a, std::size_t n, const digit* roots, const ntt_prime& m) {
+		for (std::size_t len = n >> 1, stride = 1; len; len >>= 1, stride <<= 1) {
+			for (std::size_t i = 0; i < n; i += 2 * len) {
+				auto x = a + i;
+				auto y = x + len;
+				for (std::size_t j = 0; j < len; ++j) {
+					auto u = x[j];
+					auto v = y[j];
+					x[j] = m.add(u, v);
+					y[j] = m.mont_mult(m.sub(u, v), roots[j * stride]);
+				}
+			}
+		}
+	}
+
+	// Inverse transform (decimation in time, bit-reversed order in, natural order out), unscaled
+	static void ntt_inverse(digit* a, std::size_t n, const digit* roots, const ntt_prime& m) {
+		for (std::size_t len = 1, stride = n >> 1; len < n; len <<= 1, stride >>= 1) {
+			for (std::size_t i = 0; i < n; i += 2 * len) {
+				auto x = a + i;
+				auto y = x + len;
+				for (std::size_t j = 0; j < len; ++j) {
+					auto u = x[j];
+					auto v = m.mont_mult(y[j], roots[j * stride]);
+					x[j] = m.add(u, v);
+					y[j] = m.sub(u, v);
+				}
+			}
+		}
+	}
+
+	// Cyclic convolution of lhs and rhs modulo the prime (into residues, which get n digits)
+	// When lhs and rhs are the same object only one forward transform is done.
+	static void ntt_convolve(container& residues, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t n, const ntt_prime& m) {
+		container roots;
+		ntt_roots(roots, n, m, false);
+
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		// Transform operands (into Montgomery form, for which digits need not be reduced):
+		residues.resize(n);
+		auto a = residues.data();
+		std::fill(std::transform(lhs.begin(), lhs.end(), a, [&](digit d) { return m.mont_mult(d, m.r2); }), a + n, 0);
+		ntt_forward(a, n, roots.data(), m);
+
+		if (&lhs == &rhs) {
+			// Pointwise squaring:
+			for (std::size_t i = 0; i < n; ++i) {
+				a[i] = m.mont_mult(a[i], a[i]);
+			}
+		} else {
+			container b_buffer;
+			b_buffer.resize(n);
+			auto b = b_buffer.data();
+			std::fill(std::transform(rhs.begin(), rhs.end(), b, [&](digit d) { return m.mont_mult(d, m.r2); }), b + n, 0);
+			ntt_forward(b, n, roots.data(), m);
+
+			// Pointwise multiplication:
+			for (std::size_t i = 0; i < n; ++i) {
+				a[i] = m.mont_mult(a[i], b[i]);
+			}
+		}
+
+		// Inverse transform (scaling by 1/n and leaving Montgomery form):
+		ntt_roots(roots, n, m, true);
+		ntt_inverse(a, n, roots.data(), m);
+		auto n_inv = m.mont_pow(m.mont_mult(static_cast<digit>(n), m.r2), m.p - 2);
+		n_inv = m.mont_mult(n_inv, 1);
+		for (std::size_t i = 0; i < lhs_sz + rhs_sz - 1; ++i) {
+			a[i] = m.mont_mult(a[i], n_inv);
+		}
+	}
+
+	// Recovers the exact convolution coefficients from their residues and adds them up
+	static uinteger_t& ntt_crt(uinteger_t& result, const container& r1, const container& r2, const container& r3, std::size_t sz) {
+		const auto& m1 = ntt_primes(0);
+		const auto& m2 = ntt_primes(1);
+		const auto& m3 = ntt_primes(2);
+
+		// Garner's constants (in Montgomery form, so multiplying by them is plain modular multiplication):
+		//   x = x1 + p1 (t2 + p2 t3)
+		//   t2 = (x2 - x1) / p1 mod p2
+		//   t3 = ((x3 - x1) / p1 - t2) / p2 mod p3
+		// (primes are in increasing order, so residues don't need reducing)
+		auto p1_inv_m2 = m2.mont_pow(m2.mont_mult(m1.p, m2.r2), m2.p - 2);
+		auto p1_inv_m3 = m3.mont_pow(m3.mont_mult(m1.p, m3.r2), m3.p - 2);
+		auto p2_inv_m3 = m3.mont_pow(m3.mont_mult(m2.p, m3.r2), m3.p - 2);
+
+		uinteger_t tmp;
+		tmp.resize(sz + 1, 0);
+		auto it = tmp.begin();
+
+		digit c0 = 0, c1 = 0;
+		for (std::size_t i = 0; i < sz - 1; ++i, ++it) {
+			auto x1 = r1[i];
+			auto t2 = m2.mont_mult(m2.sub(r2[i], x1), p1_inv_m2);
+			auto t3 = m3.mont_mult(m3.sub(r3[i], x1), p1_inv_m3);
+			t3 = m3.mont_mult(m3.sub(t3, t2), p2_inv_m3);
+
+			// x = (t3 p2 + t2) p1 + x1
+			digit v0;
+			auto v1 = _multadd(t3, m2.p, t2, 0, &v0);
+			digit x0, x1_;
+			auto x2 = _multadd(v0, m1.p, x1, 0, &x0);
+			x2 = _multadd(v1, m1.p, x2, 0, &x1_);
+
+			// add x and the carry
+			auto carry = _addcarry(x0, c0, 0, &*it);
+			carry = _addcarry(x1_, c1, carry, &c0);
+			c1 = x2 + carry;
+		}
+		*it++ = c0;
+		*it = c1;
+
+		// Finish up
+		tmp.trim();
+		result = std::move(tmp);
+		return result;
+	}
+
+	static uinteger_t& ntt_mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+
+		auto sz = lhs_sz + rhs_sz;
+		std::size_t n = 1;
+		while (n < sz - 1) {
+			n <<= 1;
+		}
+		ASSERT(n <= (static_cast<std::size_t>(1) << 50));
+
+		container r1, r2, r3;
+		ntt_convolve(r1, lhs, rhs, n, ntt_primes(0));
+		ntt_convolve(r2, lhs, rhs, n, ntt_primes(1));
+		ntt_convolve(r3, lhs, rhs, n, ntt_primes(2));
+
+		return ntt_crt(result, r1, r2, r3, sz);
+	}
+
+	static uinteger_t& ntt_sqr(uinteger_t& result, const uinteger_t& num) {
+		// ntt_convolve() squares when both operands are the same object
+		return ntt_mult(result, num, num);
+	}
+
+	static uinteger_t& mult(uinteger_t& lhs, const uinteger_t& rhs) {
+		// Hard to see how this could have a further optimized implementation.
+		return mult(lhs, lhs, rhs);
+	}
+
+	static uinteger_t& mult(uinteger_t& result, const uinteger_t& lhs, const uinteger_t& rhs) {
+		// First try saving some calculations:
+		if (!lhs || !rhs) {
+			result = uint_0();
+			return result;
+		}
+		if (compare_1(lhs, 1) == 0) {
+			result = rhs;
+			return result;
+		}
+		if (compare_1(rhs, 1) == 0) {
+			result = lhs;
+			return result;
+		}
+
+		if (lhs.begin() == rhs.begin() && lhs.size() == rhs.size()) {
+			// Both operands are the same digits
+			return sqr(result, lhs);
+		}
+
+		auto min_sz = std::min(lhs.size(), rhs.size());
+		if (min_sz >= ntt_cutoff && digit_bits == 64) {
+			return ntt_mult(result, lhs, rhs);
+		}
+		if (min_sz >= toom3_cutoff) {
+			return toom3_mult(result, lhs, rhs, toom3_cutoff);
+		}
+
+		return karatsuba_mult(result, lhs, rhs, karatsuba_cutoff);
+	}
+
+	static uinteger_t mult(const uinteger_t& lhs, const uinteger_t& rhs) {
+		uinteger_t result;
+		mult(result, lhs, rhs);
+		return result;
+	}
+
+	static uinteger_t& sqr(uinteger_t& result, const uinteger_t& num) {
+		// First try saving some calculations:
+		if (!num) {
+			result = uint_0();
+			return result;
+		}
+
+		auto num_sz = num.size();
+		if (num_sz >= ntt_cutoff && digit_bits == 64) {
+			return ntt_sqr(result, num);
+		}
+		if (num_sz >= toom3_cutoff) {
+			return toom3_sqr(result, num, toom3_cutoff);
+		}
+
+		return karatsuba_sqr(result, num, karatsuba_cutoff);
+	}
+
+	static uinteger_t sqr(const uinteger_t& num) {
+		uinteger_t result;
+		sqr(result, num);
+		return result;
+	}
+
+	// lhs += a b, products small enough for long multiplication are
+	// accumulated straight into lhs, without a temporary.
+	static uinteger_t& addmul(uinteger_t& lhs, const uinteger_t& a, const uinteger_t& b) {
+		auto a_sz = a.size();
+		auto b_sz = b.size();
+		if (!a_sz || !b_sz) {
+			return lhs;
+		}
+		if (b_sz == 1) {
+			return addmul_1(lhs, a, b.front());
+		}
+		if (a_sz == 1) {
+			return addmul_1(lhs, b, a.front());
+		}
+		if (&lhs._value == &a._value || &lhs._value == &b._value || std::min(a_sz, b_sz) >= karatsuba_cutoff) {
+			return add(lhs, mult(a, b));
+		}
+
+		auto lhs_sz = std::max(lhs.size(), a_sz + b_sz) + 1;
+		lhs.resize(lhs_sz, 0);
+		auto r = lhs.data();
+		for (std::size_t j = 0; j < b_sz; ++j) {
+			auto carry = _addmul_1(r + j, a.data(), a_sz, b.data()[j]);
+			_add_1(r + j + a_sz, r + j + a_sz, lhs_sz - j - a_sz, carry);
+		}
+		lhs._carry = false;
+
+		// Finish up
+		lhs.trim();
+		return lhs;
+	}
+
+	// lhs -= a b, wrapping around like sub() when a b > lhs.
+	static uinteger_t& submul(uinteger_t& lhs, const uinteger_t& a, const uinteger_t& b) {
+		auto a_sz = a.size();
+		auto b_sz = b.size();
+		if (!a_sz || !b_sz) {
+			return lhs;
+		}
+		if (b_sz == 1) {
+			return submul_1(lhs, a, b.front());
+		}
+		if (a_sz == 1) {
+			return submul_1(lhs, b, a.front());
+		}
+		auto lhs_sz = lhs.size();
+		if (&lhs._value == &a._value || &lhs._value == &b._value || std::min(a_sz, b_sz) >= karatsuba_cutoff || lhs_sz < a_sz + b_sz) {
+			return sub(lhs, mult(a, b));
+		}
+
+		auto r = lhs.data();
+		digit borrow = 0;
+		for (std::size_t j = 0; j < b_sz; ++j) {
+			auto carry = _submul_1(r + j, a.data(), a_sz, b.data()[j]);
+			borrow |= _sub_1(r + j + a_sz, r + j + a_sz, lhs_sz - j - a_sz, carry);
+		}
+		lhs._carry = borrow;
+
+		// Finish up
+		lhs.trim();
+		return lhs;
+	}
+
+	// Single word long division
+	// Fastests, but ONLY for single sized rhs
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> single_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
+		ASSERT(rhs.size() == 1);
+		return divmod_1(quotient, remainder, lhs, rhs.front());
+	}
+
+	// Divides u (un digits) by the normalized digit y, v being its reciprocal,
+	// leaves the quotient in q (un digits, q can be u) and returns the remainder.
+	static digit _divmod_1(digit* q, const digit* u, std::size_t un, digit y, digit v) {
+		digit r = 0;
+		while (un--) {
+			r = _divmod(r, u[un], y, v, &q[un]);
+		}
+		return r;
+	}
+
+	// Divides u (un digits) by the digit y (any non-zero digit), leaves the
+	// quotient in q (un digits, q can be u, or null if only the remainder is
+	// needed) and returns the remainder.
+	static digit _divrem_1(digit* q, const digit* u, std::size_t un, digit y) {
+		if (!un) {
+			return 0;
+		}
+		if (un < divrem_1_cutoff) {
+			// A plain division per digit is cheaper than the reciprocal
+			digit r = 0;
+			digit _q;
+			while (un--) {
+				r = _divmod(r, u[un], y, q ? &q[un] : &_q);
+			}
+			return r;
+		}
+		auto _digit_bits = digit_bits;
+		auto shift = _digit_bits - _bits(y);
+		y <<= shift;
+		auto v = _reciprocal(y);
+
+		// Normalize u on the fly, shifting it by the same amount as y
+		digit r = shift ? u[un - 1] >> (_digit_bits - shift) : 0;
+		digit _q;
+		while (un--) {
+			auto x = u[un] << shift;
+			if (shift && un) {
+				x |= u[un - 1] >> (_digit_bits - shift);
+			}
+			r = _divmod(r, x, y, v, q ? &q[un] : &_q);
+		}
+		return r >> shift;
+	}
+
+	// Schoolbook division of u (un digits) by the normalized d (dn >= 2 digits),
+	// v being the reciprocal of its top two digits. The top dn digits of u must be
+	// less than d. Leaves the quotient in q (un - dn digits) and the remainder in
+	// the low dn digits of u.
+	static void _divmod_n(digit* q, digit* u, std::size_t un, const digit* d, std::size_t dn, digit v) {
+		ASSERT(dn >= 2 && un > dn);
+		auto d1 = d[dn - 1];
+		auto d0 = d[dn - 2];
+		for (auto i = un - dn; i--; ) {
+			// Divide the window u[i, i + dn] by d:
+			auto w = u + i;
+			digit _q;
+			if (w[dn] == d1 && w[dn - 1] == d0) {
+				// The estimate doesn't fit in a digit, but the largest one is right
+				_q = static_cast<digit>(~static_cast<digit>(0));
+				auto borrow = _submul_1(w, d, dn, _q);
+				w[dn] = static_cast<digit>(w[dn] - borrow);
+				ASSERT(!w[dn]);
+			} else {
+				// The estimate from the top three digits is at most one too large
+				digit r1, r0;
+				_divmod(w[dn], w[dn - 1], w[dn - 2], d1, d0, v, &_q, &r1, &r0);
+				auto borrow = _submul_1(w, d, dn - 2, _q);
+				borrow = _subborrow(r0, borrow, 0, &w[dn - 2]);
+				borrow = _subborrow(r1, 0, borrow, &w[dn - 1]);
+				w[dn] = 0;
+				if (borrow) {
+					// Add d back
+					--_q;
+					_add(w, w, dn, d, dn);
+				}
+			}
+			q[i] = _q;
+		}
+	}
+
+	// Implementation of Knuth's Algorithm D
+	// For a divisor w which is already normalized (shifted left by `shift` bits so
+	// its top bit is set), and the reciprocal of its top two digits which is used
+	// to estimate the quotient digits.
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> knuth_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& w, std::size_t shift, digit inverse) {
+		auto w_size = w.size();
+		ASSERT(lhs.size() >= w_size && w_size >= 2);
+
+		// Shift lhs left by the same amount, with an extra digit on top
+		// so that its top w_size digits are less than w.
+		auto v = lhs << shift;
+		v.append(0);
+		auto v_size = v.size();
+
+		uinteger_t q;
+		q.resize(v_size - w_size);
+		_divmod_n(q.data(), v.data(), v_size, w.data(), w_size, inverse);
+
+		// Unnormalize the remainder
+		v.resize(w_size);
+		v >>= shift;
+
+		q.trim();
+		v.trim();
+
+		quotient = std::move(q);
+		remainder = std::move(v);
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> knuth_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
+		// Normalize: shift rhs left so that its top bit is set.
+		auto shift = digit_bits - _bits(rhs.back());
+		auto w = rhs << shift;
+		auto inverse = _reciprocal(*w.rbegin(), *(w.rbegin() + 1));
+		return knuth_divmod(quotient, remainder, lhs, w, shift, inverse);
+	}
+
+	// Burnikel-Ziegler recursive division
+	// Divides a 2n digit number by an n digit one (with its top bit set) using
+	// two 3n/2n divisions, which in turn use one n/2 digit division and a
+	// multiplication, so division gets to use the sub-quadratic mult().
+	// Requires a < b BASE^n.
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> burnikel_ziegler_div2n1n(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& a, const uinteger_t& b, std::size_t n, std::size_t cutoff) {
+		if (n % 2 || n < cutoff) {
+			return divmod(quotient, remainder, a, b);
+		}
+
+		// a = [a1 a2 a3 a4], b = [b1 b2] (n / 2 digits each)
+		auto h = n / 2;
+		auto b1 = toom_split(b, h, n);
+		auto b2 = toom_split(b, 0, h);
+
+		uinteger_t q1, q2, r;
+		burnikel_ziegler_div3n2n(q1, r, toom_split(a, 2 * h, 4 * h), toom_split(a, h, 2 * h), b, b1, b2, h, cutoff);
+		burnikel_ziegler_div3n2n(q2, remainder, r, toom_split(a, 0, h), b, b1, b2, h, cutoff);
+
+		add_shifted(q2, q1, h);
+		quotient = std::move(q2);
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+
+	// Divides [a12 a3] (3h digits) by b = [b1 b2] (2h digits), requires a12 < b BASE^h.
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> burnikel_ziegler_div3n2n(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& a12, const uinteger_t& a3, const uinteger_t& b, const uinteger_t& b1, const uinteger_t& b2, std::size_t h, std::size_t cutoff) {
+		uinteger_t q, r1;
+		if (compare(toom_split(a12, h, 2 * h), b1) < 0) {
+			burnikel_ziegler_div2n1n(q, r1, a12, b1, h, cutoff);
+		} else {
+			// q = BASE^h - 1, r1 = a12 - q b1 = a12 - b1 BASE^h + b1
+			q.resize(h, static_cast<digit>(-1));
+			r1 = a12 + b1;
+			uinteger_t b1_shifted;
+			b1_shifted.resize(h, 0);
+			b1_shifted.append(b1);
+			r1 -= b1_shifted;
+		}
+
+		// r = r1 BASE^h + a3 - q b2, the estimate q is at most 2 too large:
+		uinteger_t r(a3);
+		add_shifted(r, r1, h);
+		uinteger_t d;
+		mult(d, q, b2);
+		while (compare(r, d) < 0) {
+			--q;
+			r += b;
+		}
+		r -= d;
+
+		quotient = std::move(q);
+		remainder = std::move(r);
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> burnikel_ziegler_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff = burnikel_ziegler_cutoff) {
+		auto rhs_sz = rhs.size();
+
+		// Block size n = j m, with m a power of two and j < cutoff,
+		// so that the recursion halves blocks down to j digits.
+		std::size_t m = 1;
+		while (m * cutoff <= rhs_sz) {
+			m <<= 1;
+		}
+		auto n = (rhs_sz + m - 1) / m * m;
+
+		// Normalize: shift both so rhs has exactly n digits and its top bit set.
+		auto shift = n * digit_bits - rhs.bits();
+		auto a = lhs << shift;
+		auto b = rhs << shift;
+
+		// Split a in t blocks of n digits, the top one with its top bit clear
+		// (so that it is less than b).
+		auto t = std::max((a.bits() + n * digit_bits) / (n * digit_bits), static_cast<std::size_t>(2));
+
+		uinteger_t q, r;
+		auto z = toom_split(a, (t - 2) * n, t * n);
+		for (auto i = t - 2; ; --i) {
+			uinteger_t qi;
+			burnikel_ziegler_div2n1n(qi, r, z, b, n, cutoff);
+			add_shifted(q, qi, i * n);
+			if (!i) {
+				break;
+			}
+			z = toom_split(a, (i - 1) * n, i * n);
+			add_shifted(z, r, n);
+		}
+
+		quotient = std::move(q);
+		remainder = r >> shift;
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+
+	// Newton reciprocal
+	// Approximates floor(BASE^(2 n) / num), for an n digit num with its top bit
+	// set, to within a unit or so. The reciprocal x' of the top h digits of num
+	// is refined with one Newton step:
+	//   x = x' BASE^(n - h) + x' e / BASE^(2 h), for e = BASE^(n + h) - num x'
+	// Only the top digits of the error e are needed, so a step costs about
+	// one n by h and one h by h digit multiplication.
+	static uinteger_t& newton_reciprocal(uinteger_t& result, const uinteger_t& num, std::size_t cutoff = newton_cutoff) {
+		auto n = num.size();
+		ASSERT(n && (num.back() >> (digit_bits - 1)));
+
+		if (n <= std::max(cutoff, static_cast<std::size_t>(2))) {
+			uinteger_t power;
+			power.resize(2 * n, 0);
+			power.append(1);
+			uinteger_t remainder;
+			divmod(result, remainder, power, num);
+			return result;
+		}
+
+		// One more than half the digits, so the error of xh (which gets
+		// squared by the Newton step) vanishes in x.
+		auto h = n / 2 + 1;
+		auto k = n - h;
+
+		uinteger_t xh;
+		newton_reciprocal(xh, toom_split(num, k, n), cutoff);
+
+		// e = BASE^(n + h) - num xh, as magnitude and sign:
+		uinteger_t e;
+		e.resize(n + h, 0);
+		e.append(1);
+		uinteger_t p;
+		mult(p, num, xh);
+		bool e_negative = false;
+		toom_signed_sub(e, e_negative, p, false);
+
+		// x = xh BASE^k +/- floor(xh floor(e / BASE^(h - 1)) / BASE^(h + 1))
+		uinteger_t t;
+		mult(t, xh, toom_split(e, h - 1, e.size()));
+		t = toom_split(t, h + 1, t.size());
+		uinteger_t x;
+		x.resize(k, 0);
+		x.append(xh);
+		if (e_negative) {
+			x -= t;
+		} else {
+			x += t;
+		}
+
+		result = std::move(x);
+		return result;
+	}
+
+	// Division by multiplying with the reciprocal of the divisor
+	// The dividend is consumed from the top in chunks which are less than
+	// rhs BASE^n (for an n digit rhs), each costing two n digit multiplications.
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> newton_divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs, std::size_t cutoff = newton_cutoff) {
+		// Normalize: shift both so rhs has its top bit set.
+		auto shift = digit_bits - _bits(rhs.back());
+		auto a = lhs << shift;
+		auto d = rhs << shift;
+		auto n = d.size();
+
+		uinteger_t inverse;
+		newton_reciprocal(inverse, d, cutoff);
+
+		// The first chunk takes the top 2 n digits (or 2 n - 1, if those are too big):
+		auto a_sz = a.size();
+		auto pos = a_sz > 2 * n ? a_sz - 2 * n : 0;
+		auto x = toom_split(a, pos, a_sz);
+		if (compare(toom_split(x, n, x.size()), d) >= 0) {
+			x = toom_split(a, ++pos, a_sz);
+		}
+
+		uinteger_t q, r;
+		while (true) {
+			// Estimate floor(x inverse / BASE^(2 n)) from the top digits of x
+			// and correct it (it is off by a few units at most):
+			uinteger_t qi;
+			mult(qi, toom_split(x, n - 1, 2 * n), inverse);
+			qi = toom_split(qi, n + 1, qi.size());
+			uinteger_t p;
+			mult(p, qi, d);
+			while (compare(p, x) > 0) {
+				--qi;
+				p -= d;
+			}
+			sub(r, x, p);
+			while (compare(r, d) >= 0) {
+				++qi;
+				r -= d;
+			}
+			add_shifted(q, qi, pos);
+
+			if (!pos) {
+				break;
+			}
+
+			// Next chunk, r BASE^m + the next m digits (m <= n):
+			auto m = std::min(n, pos);
+			pos -= m;
+			x = toom_split(a, pos, pos + m);
+			add_shifted(x, r, m);
+		}
+
+		quotient = std::move(q);
+		remainder = r >> shift;
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const uinteger_t& rhs) {
+		// First try saving some calculations:
+		if (!rhs) {
+			throw std::domain_error("Error: division or modulus by 0");
+		}
+		auto lhs_sz = lhs.size();
+		auto rhs_sz = rhs.size();
+		if (lhs_sz == 1 && rhs_sz == 1) {
+			// Fast division and modulo for single value
+			auto a = *lhs.begin();
+			auto b = *rhs.begin();
+			quotient = a / b;
+			remainder = a % b;
+			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		}
+		if (compare_1(rhs, 1) == 0) {
+			quotient = lhs;
+			remainder = uint_0();
+			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		}
+		auto compared = compare(lhs, rhs);
+		if (compared == 0) {
+			quotient = uint_1();
+			remainder = uint_0();
+			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		}
+		if (!lhs || compared < 0) {
+			quotient = uint_0();
+			remainder = lhs;
+			return std::make_pair(std::ref(quotient), std::ref(remainder));
+		}
+		if (rhs_sz == 1) {
+			return single_divmod(quotient, remainder, lhs, rhs);
+		}
+		if (rhs_sz >= newton_cutoff && lhs_sz - rhs_sz >= 8 * newton_cutoff) {
+			// The reciprocal pays off for large quotients
+			return newton_divmod(quotient, remainder, lhs, rhs, newton_cutoff);
+		}
+		if (rhs_sz >= burnikel_ziegler_cutoff && lhs_sz - rhs_sz >= burnikel_ziegler_cutoff) {
+			return burnikel_ziegler_divmod(quotient, remainder, lhs, rhs, burnikel_ziegler_cutoff);
+		}
+
+		return knuth_divmod(quotient, remainder, lhs, rhs);
+	}
+
+	static std::pair<uinteger_t, uinteger_t> divmod(const uinteger_t& lhs, const uinteger_t& rhs) {
+		uinteger_t quotient;
+		uinteger_t remainder;
+		divmod(quotient, remainder, lhs, rhs);
+		return std::make_pair(std::move(quotient), std::move(remainder));
+	}
+
+	static std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const divisor& rhs);
+
+	static std::pair<uinteger_t, uinteger_t> divmod(const uinteger_t& lhs, const divisor& rhs);
+
+	// Window size for sliding window exponentiation, for an exponent of the given bits
+	static std::size_t _window_bits(std::size_t bits) {
+		if (bits <= 8) return 1;
+		if (bits <= 24) return 2;
+		if (bits <= 80) return 3;
+		if (bits <= 240) return 4;
+		if (bits <= 672) return 5;
+		if (bits <= 1792) return 6;
+		return 7;
+	}
+
+	// Left to right sliding window exponentiation, for a non-zero exp.
+	// Windows of up to k bits always end on a set bit, so only the odd
+	// powers base^(2 i + 1) are needed (the table, indexed by i):
+	// assign(i) sets the result to the table entry i (for the first window),
+	// mult(i) multiplies the result by it and sqr() squares the result.
+	template <typename Assign, typename Mult, typename Sqr>
+	static void _sliding_window(const uinteger_t& exp, std::size_t k, Assign assign, Mult mult, Sqr sqr) {
+		bool started = false;
+		auto i = exp.bits();
+		while (i) {
+			if (!exp[i - 1]) {
+				sqr();
+				--i;
+				continue;
+			}
+			// the longest window [l, i) of up to k bits ending on a set bit:
+			auto l = i > k ? i - k : 0;
+			while (!exp[l]) {
+				++l;
+			}
+			std::size_t window = 0;
+			for (auto j = i; j != l; --j) {
+				window = (window << 1) | exp[j - 1];
+			}
+			if (started) {
+				for (auto j = l; j != i; ++j) {
+					sqr();
+				}
+				mult(window >> 1);
+			} else {
+				assign(window >> 1);
+				started = true;
+			}
+			i = l;
+		}
+	}
+
+	// Sliding window exponentiation on the n digit buffers of a modular context
+	// (montgomery_ctx or barrett_ctx): table holds the base (in the context's
+	// form) followed by room for 1 << (k - 1) more entries, r gets the result.
+	template <typename Ctx>
+	static void _powmod(digit* r, digit* table, const uinteger_t& exp, std::size_t k, const Ctx& ctx, digit* scratch) {
+		auto n = ctx.size();
+		std::size_t table_sz = 1 << (k - 1);
+
+		// table[i] = base^(2 i + 1)
+		if (table_sz > 1) {
+			auto base2 = table + table_sz * n;
+			ctx.sqr(base2, table, scratch);
+			for (std::size_t i = 1; i < table_sz; ++i) {
+				ctx.mult(table + i * n, table + (i - 1) * n, base2, scratch);
+			}
+		}
+
+		_sliding_window(exp, k,
+			[&](std::size_t i) { std::copy(table + i * n, table + (i + 1) * n, r); },
+			[&](std::size_t i) { ctx.mult(r, r, table + i * n, scratch); },
+			[&]() { ctx.sqr(r, r, scratch); });
+	}
+
+	// GCD
+	// Every reduction step subtracts a multiple of one of the numbers from
+	// the other, so the coefficients of the first operand in both numbers
+	// (the cofactors, tracked for the extended GCD) always have opposite
+	// signs and only their magnitudes need to be kept.
+	struct cofactors;
+
+	// Matrix of the reductions done by the half-GCD, (a, b) = M (a', b'),
+	// it has non-negative entries and determinant 1.
+	struct hgcd_matrix;
+
+	// Binary GCD of two digits
+	static digit _gcd_1(digit a, digit b) {
+		if (!a) return b;
+		if (!b) return a;
+		auto shift = _trailing_zeros(a | b);
+		a >>= _trailing_zeros(a);
+		while (b) {
+			b >>= _trailing_zeros(b);
+			if (a > b) {
+				std::swap(a, b);
+			}
+			b -= a;
+		}
+		return a << shift;
+	}
+
+	// Digit formed by the bits of num starting at the given bit
+	static digit _digit_at(const uinteger_t& num, std::size_t bit) {
+		auto idx = bit / digit_bits;
+		auto shift = bit % digit_bits;
+		auto x = num.value(idx) >> shift;
+		if (shift) {
+			x |= num.value(idx + 1) << (digit_bits - shift);
+		}
+		return x;
+	}
+
+	// Checks if x > B^s (B being the digits base)
+	static bool _above(const uinteger_t& x, std::size_t s) {
+		auto sz = x.size();
+		if (sz != s + 1) {
+			return sz > s + 1;
+		}
+		auto data = x.data();
+		return data[s] > 1 || std::any_of(data, data + s, [](digit d) { return d != 0; });
+	}
+
+	static void _euclid_step(uinteger_t& a, uinteger_t& b, uinteger_t& quotient, uinteger_t& remainder, cofactors* co);
+	static std::size_t _lehmer(const uinteger_t& a, const uinteger_t& b, digit (&cofactors)[4]);
+	static void _lehmer_combine(uinteger_t& result, const uinteger_t& u, digit p, const uinteger_t& v, digit q, std::size_t n);
+	static bool _lehmer_step(uinteger_t& a, uinteger_t& b, uinteger_t& c, uinteger_t& d, cofactors* co);
+	static bool _hgcd_lehmer_step(uinteger_t& a, uinteger_t& b, std::size_t s, hgcd_matrix& m, uinteger_t& c, uinteger_t& d);
+	static bool _hgcd_step(uinteger_t& a, uinteger_t& b, std::size_t s, const uinteger_t& bound, hgcd_matrix& m, uinteger_t& q, uinteger_t& r);
+	static void _hgcd_apply(uinteger_t& a, uinteger_t& b, const hgcd_matrix& m, uinteger_t& c, uinteger_t& d);
+	static bool _hgcd(uinteger_t& a, uinteger_t& b, hgcd_matrix& m);
+	static void _gcd(uinteger_t& a, uinteger_t& b, cofactors* co);
+
+	// String conversion
+	// Appends exactly count characters of the chunk c, the least significant first,
+	// two at a time
+	template <typename Result>
+	static void _str_chunk(Result& result, digit c, int alphabet_base, unsigned count) {
+		static constexpr const char decimal_pairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		if (alphabet_base == 10) {
+			for (; count >= 2; count -= 2) {
+				auto pair = &decimal_pairs[(c % 100) * 2];
+				c /= 100;
+				result.push_back(pair[1]);
+				result.push_back(pair[0]);
+			}
+		} else {
+			digit base = alphabet_base;
+			digit base_2 = base * base;
+			for (; count >= 2; count -= 2) {
+				auto pair = c % base_2;
+				c /= base_2;
+				result.push_back(chr(static_cast<int>(pair % base)));
+				result.push_back(chr(static_cast<int>(pair / base)));
+			}
+		}
+		if (count) {
+			result.push_back(chr(static_cast<int>(c % alphabet_base)));
+		}
+	}
+
+	template <typename Result>
+	static void _str(Result& result, const uinteger_t& num, int alphabet_base, const std::vector<divisor>& powers, std::size_t k, std::size_t width);
+
+	// Parses count characters (no more than base_chunk_size()) into a digit,
+	// end being the end of the whole string (for errors)
+	static digit _strtouint_chunk(const char* data, std::size_t count, int alphabet_base, const char* end) {
+		digit chunk = 0;
+	#if defined HAVE_LITTLE_ENDIAN
+		if (alphabet_base == 10) {
+			// Eight characters at a time, within a 64-bit word (SWAR)
+			for (; count >= 8; count -= 8, data += 8) {
+				std::uint64_t v;
+				std::memcpy(&v, data, 8);
+				if ((v & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL || ((v + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL) {
+					break;  // not all digits, the loop below finds which
+				}
+				v -= 0x3030303030303030ULL;
+				v = (v * 10) + (v >> 8);
+				v = (((v & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) + (((v >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >> 32;
+				chunk = chunk * 100000000 + static_cast<digit>(v);
+			}
+		}
+	#endif
+		for (; count; --count, ++data) {
+			auto d = ord(static_cast<int>(*data));
+			if (d < 0 || d >= alphabet_base) {
+				throw std::invalid_argument("Error: Not a digit in base " + std::to_string(alphabet_base) + ": '" + std::string(1, *data) + "' at " + std::to_string(end - data));
+			}
+			chunk = chunk * alphabet_base + d;
+		}
+		return chunk;
+	}
+
+#if defined HAVE_SSE2 && (defined HAVE____BUILTIN_BSWAP64 || defined HAVE___BYTESWAP_UINT64)
+	// Decodes 16 hexadecimal characters (the most significant first) into r,
+	// returns false if any of them is not a hexadecimal digit
+	static bool _strtouint_hex16(const char* data, std::uint64_t* r) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		auto is_digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+		auto is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+		if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xffff) {
+			return false;
+		}
+
+		// nibbles: the low four bits, plus 9 for letters
+		auto nibbles = _mm_add_epi8(_mm_and_si128(v, _mm_set1_epi8(0x0f)), _mm_and_si128(is_alpha, _mm_set1_epi8(9)));
+		// pairs of nibbles into bytes, the first one high
+		auto bytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00ff)), 4), _mm_srli_epi16(nibbles, 8));
+		bytes = _mm_packus_epi16(bytes, bytes);
+		std::uint64_t x;
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&x), bytes);
+	#if defined HAVE____BUILTIN_BSWAP64
+		*r = __builtin_bswap64(x);
+	#else
+		*r = _byteswap_uint64(x);
+	#endif
+		return true;
+	}
+#endif
+
+	// Parses size characters in a power of two base (of the given bits per
+	// character) into result, packing them straight into the digits starting
+	// from the least significant character
+	static void _strtouint_bits(uinteger_t& result, const char* data, std::size_t size, int alphabet_base, std::size_t bits) {
+		auto end = data + size;
+		auto _digit_bits = digit_bits;
+		result.resize((size * bits + _digit_bits - 1) / _digit_bits);
+		auto r = result.data();
+		std::size_t n = 0;
+		digit acc = 0;
+		std::size_t acc_bits = 0;
+		for (auto ptr = end; ptr != data;) {
+	#if defined HAVE_SSE2 && (defined HAVE____BUILTIN_BSWAP64 || defined HAVE___BYTESWAP_UINT64)
+			if (digit_bits == 64 && bits == 4 && !acc_bits && ptr - data >= 16) {
+				// a whole digit, aligned since 16 characters fill it exactly
+				std::uint64_t x;
+				if (_strtouint_hex16(ptr - 16, &x)) {
+					r[n++] = static_cast<digit>(x);
+					ptr -= 16;
+					continue;
+				}
+			}
+	#endif
+			--ptr;
+			auto d = ord(static_cast<int>(*ptr));
+			if (d < 0 || d >= alphabet_base) {
+				throw std::invalid_argument("Error: Not a digit in base " + std::to_string(alphabet_base) + ": '" + std::string(1, *ptr) + "' at " + std::to_string(end - ptr));
+			}
+			acc |= static_cast<digit>(d) << acc_bits;
+			acc_bits += bits;
+			if (acc_bits >= _digit_bits) {
+				r[n++] = acc;
+				acc_bits -= _digit_bits;
+				acc = acc_bits ? static_cast<digit>(d) >> (bits - acc_bits) : 0;
+			}
+		}
+		if (acc_bits) {
+			r[n++] = acc;
+		}
+		result.resize(n);
+		result.trim();
+	}
+
+	// Parses size characters into result, by chunks of as many characters as fit
+	// in a digit, below strtouint_cutoff digits. Above it, the leading and the
+	// trailing chunk_size * 2^(k-1) characters are parsed separately and
+	// combined with a multiplication by powers[k - 1] = chunk^(2^(k-1)).
+	static void _strtouint(uinteger_t& result, const char* data, std::size_t size, int alphabet_base, const std::vector<uinteger_t>& powers, std::size_t k, const char* end) {
+		std::size_t chunk_size = base_chunk_size(alphabet_base);
+		auto chunks = (size + chunk_size - 1) / chunk_size;
+		if (k == 0 || chunks < strtouint_cutoff) {
+			auto chunk = base_chunk(alphabet_base);
+			result.resize(chunks);
+			auto r = result.data();
+			std::size_t n = 0;
+
+			// the leading chunk may be shorter
+			auto count = size - (chunks - 1) * chunk_size;
+			for (; size; size -= count, data += count, count = chunk_size) {
+				auto c = _strtouint_chunk(data, count, alphabet_base, end);
+				// r = r chunk + c (the short chunk is the first one, when r is still empty)
+				auto carry = _mul_1(r, r, n, chunk);
+				carry += _add_1(r, r, n, c);
+				if (carry) {
+					r[n++] = carry;
+				}
+			}
+			result.resize(n);
+		} else {
+			auto low_size = chunk_size << (k - 1);
+			if (size <= low_size) {
+				_strtouint(result, data, size, alphabet_base, powers, k - 1, end);
+				return;
+			}
+			uinteger_t low;
+			_strtouint(result, data, size - low_size, alphabet_base, powers, k - 1, end);
+			_strtouint(low, data + size - low_size, low_size, alphabet_base, powers, k - 1, end);
+			mult(result, powers[k - 1]);
+			add(result, low);
+		}
+	}
+
+private:
+	// Constructors
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	void _uint_t(const T& value) {
+		append(static_cast<digit>(value));
+	}
+
+	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	void _uint_t(const T& value, Args... args) {
+		_uint_t(args...);
+		append(static_cast<digit>(value));
+	}
+
+	// This constructor creates a window view of the _value
+	uinteger_t(const uinteger_t& o, std::size_t begin, std::size_t end) :
+		_begin(begin),
 		_end(end),
 		_value(o._value),
 		_carry(o._carry) { }
 
-public:
-	uinteger_t() :
-		_begin(0),
-		_end(0),
-		_value(_value_instance),
-		_carry(false) { }
+public:
+	uinteger_t() :
+		_begin(0),
+		_end(0),
+		_value(_value_instance),
+		_carry(false) { }
+
+	explicit uinteger_t(memory_resource* resource) :
+		_begin(0),
+		_end(0),
+		_value_instance(resource),
+		_value(_value_instance),
+		_carry(false) { }
+
+	uinteger_t(const uinteger_t& o) :
+		_begin(0),
+		_end(0),
+		_value_instance(o.begin(), o.end()),
+		_value(_value_instance),
+		_carry(o._carry) { }
+
+	uinteger_t(const uinteger_t& o, memory_resource* resource) :
+		_begin(0),
+		_end(0),
+		_value_instance(o.begin(), o.end(), resource),
+		_value(_value_instance),
+		_carry(o._carry) { }
+
+	uinteger_t(uinteger_t&& o) :
+		_begin(std::move(o._begin)),
+		_end(std::move(o._end)),
+		_value_instance(std::move(o._value_instance)),
+		_value(_value_instance),
+		_carry(std::move(o._carry)) { }
+
+	template <typename Lhs, typename Rhs, char Op>
+	uinteger_t(const lazy_expression<Lhs, Rhs, Op>& expr);
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t(const T& value) :
+		_begin(0),
+		_end(0),
+		_value(_value_instance),
+		_carry(false) {
+		if (value) {
+			append(static_cast<digit>(value));
+		}
+	}
+
+	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t(const T& value, Args... args) :
+		_begin(0),
+		_end(0),
+		_value(_value_instance),
+		_carry(false) {
+		_uint_t(args...);
+		append(static_cast<digit>(value));
+		trim();
+	}
+
+	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t(std::initializer_list<T> list) :
+		_begin(0),
+		_end(0),
+		_value(_value_instance),
+		_carry(false) {
+		reserve(list.size());
+		for (const auto& value : list) {
+			append(static_cast<digit>(value));
+		}
+		trim();
+	}
+
+	template <typename T, std::size_t N>
+	explicit uinteger_t(T (&s)[N], int base=10) :
+		uinteger_t(s, N - 1, base) { }
+
+	explicit uinteger_t(const unsigned char* bytes, std::size_t sz, int base) :
+		uinteger_t(strtouint(bytes, sz, base)) { }
+
+	explicit uinteger_t(const char* bytes, std::size_t sz, int base) :
+		uinteger_t(strtouint(bytes, sz, base)) { }
+
+	template <typename T>
+	explicit uinteger_t(const std::vector<T>& bytes, int base=10) :
+		uinteger_t(bytes.data(), bytes.size(), base) { }
+
+	explicit uinteger_t(const std::string& bytes, int base=10) :
+		uinteger_t(bytes.data(), bytes.size(), base) { }
+
+	// Assignment Operator
+	uinteger_t& operator=(const uinteger_t& o) {
+		// reuses the existing capacity
+		_value.assign(o.begin(), o.end());
+		_begin = 0;
+		_end = 0;
+		_carry = o._carry;
+		return *this;
+	}
+	uinteger_t& operator=(uinteger_t&& o) {
+		_begin = std::move(o._begin);
+		_end = std::move(o._end);
+		_value_instance = std::move(o._value_instance);
+		_carry = std::move(o._carry);
+		return *this;
+	}
+
+	template <typename Lhs, typename Rhs, char Op>
+	uinteger_t& operator=(const lazy_expression<Lhs, Rhs, Op>& expr);
+
+	template <typename Lhs, typename Rhs, char Op>
+	uinteger_t& operator+=(const lazy_expression<Lhs, Rhs, Op>& expr);
+
+	template <typename Lhs, typename Rhs, char Op>
+	uinteger_t& operator-=(const lazy_expression<Lhs, Rhs, Op>& expr);
+
+	// Typecast Operators
+	explicit operator bool() const {
+		return static_cast<bool>(size());
+	}
+	explicit operator unsigned char() const {
+		return static_cast<unsigned char>(size() ? front() : 0);
+	}
+	explicit operator unsigned short() const {
+		return static_cast<unsigned short>(size() ? front() : 0);
+	}
+	explicit operator unsigned int() const {
+		return static_cast<unsigned int>(size() ? front() : 0);
+	}
+	explicit operator unsigned long() const {
+		return static_cast<unsigned long>(size() ? front() : 0);
+	}
+	explicit operator unsigned long long() const {
+		return static_cast<unsigned long long>(size() ? front() : 0);
+	}
+	explicit operator char() const {
+		return static_cast<char>(size() ? front() : 0);
+	}
+	explicit operator short() const {
+		return static_cast<short>(size() ? front() : 0);
+	}
+	explicit operator int() const {
+		return static_cast<int>(size() ? front() : 0);
+	}
+	explicit operator long() const {
+		return static_cast<long>(size() ? front() : 0);
+	}
+	explicit operator long long() const {
+		return static_cast<long long>(size() ? front() : 0);
+	}
+
+	// Bitwise Operators
+	uinteger_t operator&(const uinteger_t& rhs) const & {
+		return bitwise_and(*this, rhs);
+	}
+
+	uinteger_t operator&(const uinteger_t& rhs) && {
+		return std::move(bitwise_and(*this, rhs));
+	}
+
+	uinteger_t operator&(uinteger_t&& rhs) const & {
+		return std::move(bitwise_and(rhs, *this));
+	}
+
+	uinteger_t operator&(uinteger_t&& rhs) && {
+		return std::move(bitwise_and(*this, rhs));
+	}
+
+	uinteger_t& operator&=(const uinteger_t& rhs) {
+		return bitwise_and(*this, rhs);
+	}
+
+	uinteger_t operator|(const uinteger_t& rhs) const & {
+		return bitwise_or(*this, rhs);
+	}
+
+	uinteger_t operator|(const uinteger_t& rhs) && {
+		return std::move(bitwise_or(*this, rhs));
+	}
+
+	uinteger_t operator|(uinteger_t&& rhs) const & {
+		return std::move(bitwise_or(rhs, *this));
+	}
+
+	uinteger_t operator|(uinteger_t&& rhs) && {
+		return std::move(bitwise_or(*this, rhs));
+	}
+
+	uinteger_t& operator|=(const uinteger_t& rhs) {
+		return bitwise_or(*this, rhs);
+	}
+
+	uinteger_t operator^(const uinteger_t& rhs) const & {
+		return bitwise_xor(*this, rhs);
+	}
+
+	uinteger_t operator^(const uinteger_t& rhs) && {
+		return std::move(bitwise_xor(*this, rhs));
+	}
+
+	uinteger_t operator^(uinteger_t&& rhs) const & {
+		return std::move(bitwise_xor(rhs, *this));
+	}
+
+	uinteger_t operator^(uinteger_t&& rhs) && {
+		return std::move(bitwise_xor(*this, rhs));
+	}
+
+	uinteger_t& operator^=(const uinteger_t& rhs) {
+		return bitwise_xor(*this, rhs);
+	}
+
+	uinteger_t operator~() const {
+		return bitwise_inv(*this);
+	}
+
+	uinteger_t inv() {
+		return bitwise_inv(*this);
+	}
+
+	// Bit Shift Operators
+	uinteger_t operator<<(std::size_t rhs) const & {
+		return bitwise_lshift(*this, rhs);
+	}
+
+	uinteger_t operator<<(std::size_t rhs) && {
+		return std::move(bitwise_lshift(*this, rhs));
+	}
+
+	uinteger_t& operator<<=(std::size_t rhs) {
+		return bitwise_lshift(*this, rhs);
+	}
+
+	uinteger_t operator>>(std::size_t rhs) const & {
+		return bitwise_rshift(*this, rhs);
+	}
+
+	uinteger_t operator>>(std::size_t rhs) && {
+		return std::move(bitwise_rshift(*this, rhs));
+	}
+
+	uinteger_t& operator>>=(std::size_t rhs) {
+		return bitwise_rshift(*this, rhs);
+	}
+
+	uinteger_t operator<<(const uinteger_t& rhs) const & {
+		return bitwise_lshift(*this, rhs);
+	}
+
+	uinteger_t operator<<(const uinteger_t& rhs) && {
+		return std::move(bitwise_lshift(*this, rhs));
+	}
+
+	uinteger_t& operator<<=(const uinteger_t& rhs) {
+		return bitwise_lshift(*this, rhs);
+	}
+
+	uinteger_t operator>>(const uinteger_t& rhs) const & {
+		return bitwise_rshift(*this, rhs);
+	}
+
+	uinteger_t operator>>(const uinteger_t& rhs) && {
+		return std::move(bitwise_rshift(*this, rhs));
+	}
+
+	uinteger_t& operator>>=(const uinteger_t& rhs) {
+		return bitwise_rshift(*this, rhs);
+	}
+
+	// Logical Operators
+	bool operator!() const {
+		return !static_cast<bool>(*this);
+	}
+
+	bool operator&&(const uinteger_t& rhs) const {
+		return static_cast<bool>(*this) && rhs;
+	}
+
+	bool operator||(const uinteger_t& rhs) const {
+		return static_cast<bool>(*this) || rhs;
+	}
+
+	// Comparison Operators
+	bool operator==(const uinteger_t& rhs) const {
+		return compare(*this, rhs) == 0;
+	}
+
+	bool operator!=(const uinteger_t& rhs) const {
+		return compare(*this, rhs) != 0;
+	}
+
+	bool operator>(const uinteger_t& rhs) const {
+		return compare(*this, rhs) > 0;
+	}
+
+	bool operator<(const uinteger_t& rhs) const {
+		return compare(*this, rhs) < 0;
+	}
+
+	bool operator>=(const uinteger_t& rhs) const {
+		return compare(*this, rhs) >= 0;
+	}
+
+	bool operator<=(const uinteger_t& rhs) const {
+		return compare(*this, rhs) <= 0;
+	}
+
+	// Arithmetic Operators
+	uinteger_t operator+(const uinteger_t& rhs) const & {
+		return add(*this, rhs);
+	}
+
+	uinteger_t operator+(const uinteger_t& rhs) && {
+		return std::move(add(*this, rhs));
+	}
+
+	uinteger_t operator+(uinteger_t&& rhs) const & {
+		return std::move(add(rhs, *this));
+	}
+
+	uinteger_t operator+(uinteger_t&& rhs) && {
+		return std::move(add(*this, rhs));
+	}
+
+	uinteger_t& operator+=(const uinteger_t& rhs) {
+		return add(*this, rhs);
+	}
+
+	uinteger_t operator-(const uinteger_t& rhs) const & {
+		return sub(*this, rhs);
+	}
+
+	uinteger_t operator-(const uinteger_t& rhs) && {
+		return std::move(sub(*this, rhs));
+	}
+
+	uinteger_t operator-(uinteger_t&& rhs) const & {
+		return std::move(sub(rhs, *this, rhs));
+	}
+
+	uinteger_t operator-(uinteger_t&& rhs) && {
+		return std::move(sub(*this, rhs));
+	}
+
+	uinteger_t& operator-=(const uinteger_t& rhs) {
+		return sub(*this, rhs);
+	}
+
+	uinteger_t operator*(const uinteger_t& rhs) const & {
+		return mult(*this, rhs);
+	}
+
+	uinteger_t operator*(const uinteger_t& rhs) && {
+		return std::move(mult(*this, rhs));
+	}
+
+	uinteger_t operator*(uinteger_t&& rhs) const & {
+		return std::move(mult(rhs, *this));
+	}
+
+	uinteger_t operator*(uinteger_t&& rhs) && {
+		return std::move(mult(*this, rhs));
+	}
+
+	uinteger_t& operator*=(const uinteger_t& rhs) {
+		return mult(*this, rhs);
+	}
+
+	uinteger_t sqr() const {
+		return sqr(*this);
+	}
+
+	// Fused multiply-accumulate: `acc.addmul(price, qty)` does `acc += price * qty`
+	// without building the product (for long multiplication sized operands).
+	uinteger_t& addmul(const uinteger_t& a, const uinteger_t& b) {
+		return addmul(*this, a, b);
+	}
+
+	uinteger_t& submul(const uinteger_t& a, const uinteger_t& b) {
+		return submul(*this, a, b);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& addmul(const uinteger_t& a, const T& b) {
+		return addmul_1(*this, a, static_cast<digit>(b));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& submul(const uinteger_t& a, const T& b) {
+		return submul_1(*this, a, static_cast<digit>(b));
+	}
+
+	// Greatest common divisor and least common multiple
+	static uinteger_t gcd(const uinteger_t& a, const uinteger_t& b);
+	static uinteger_t lcm(const uinteger_t& a, const uinteger_t& b);
+
+	// Extended GCD, with the Bezout coefficients (see bezout)
+	struct bezout;
+	static bezout gcdext(const uinteger_t& a, const uinteger_t& b);
+
+	// Modular inverse, x such that a x = 1 (mod m)
+	static uinteger_t invmod(const uinteger_t& a, const uinteger_t& m);
+
+	// Modular exponentiation, base^exp mod m
+	static uinteger_t powmod(const uinteger_t& base, const uinteger_t& exp, const uinteger_t& mod);
+	static uinteger_t powmod(const uinteger_t& base, const uinteger_t& exp, const montgomery_ctx& ctx);
+	static uinteger_t powmod(const uinteger_t& base, const uinteger_t& exp, const barrett_ctx& ctx);
+
+	// Sum of the products of the pairs of elements in a and b (up to the
+	// shortest of them), accumulated in a single growing result.
+	template <typename RangeA, typename RangeB>
+	static uinteger_t dot(const RangeA& a, const RangeB& b) {
+		uinteger_t result;
+		uinteger_t product;  // reused for products too big to be accumulated in place
+		auto a_it = std::begin(a);
+		auto a_it_e = std::end(a);
+		auto b_it = std::begin(b);
+		auto b_it_e = std::end(b);
+		for (; a_it != a_it_e && b_it != b_it_e; ++a_it, ++b_it) {
+			const uinteger_t& x = *a_it;
+			const uinteger_t& y = *b_it;
+			if (std::min(x.size(), y.size()) >= karatsuba_cutoff) {
+				mult(product, x, y);
+				add(result, product);
+			} else {
+				addmul(result, x, y);
+			}
+		}
+		return result;
+	}
+
+	std::pair<uinteger_t, uinteger_t> divmod(const uinteger_t& rhs) const {
+		return divmod(*this, rhs);
+	}
+
+	uinteger_t operator/(const uinteger_t& rhs) const {
+		return divmod(*this, rhs).first;
+	}
+
+	uinteger_t& operator/=(const uinteger_t& rhs) {
+		uinteger_t quotient;
+		uinteger_t remainder;
+		divmod(quotient, remainder, *this, rhs);
+		*this = std::move(quotient);
+		return *this;
+	}
+
+	uinteger_t operator%(const uinteger_t& rhs) const {
+		return divmod(*this, rhs).second;
+	}
+
+	uinteger_t& operator%=(const uinteger_t& rhs) {
+		uinteger_t quotient;
+		uinteger_t remainder;
+		divmod(quotient, remainder, *this, rhs);
+		*this = std::move(remainder);
+		return *this;
+	}
+
+	std::pair<uinteger_t, uinteger_t> divmod(const divisor& rhs) const;
+	uinteger_t operator/(const divisor& rhs) const;
+	uinteger_t& operator/=(const divisor& rhs);
+	uinteger_t operator%(const divisor& rhs) const;
+	uinteger_t& operator%=(const divisor& rhs);
+
+	// Operators with native integers
+	// (done on a single digit, without building a uinteger_t for rhs)
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator&(const T& rhs) const & {
+		return size() ? front() & static_cast<digit>(rhs) : 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator&(const T& rhs) && {
+		return std::move(*this &= rhs);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator&=(const T& rhs) {
+		if (size()) {
+			resize(1);
+			front() &= static_cast<digit>(rhs);
+			trim();
+		}
+		return *this;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator|(const T& rhs) const & {
+		uinteger_t result(*this);
+		return result |= rhs;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator|(const T& rhs) && {
+		return std::move(*this |= rhs);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator|=(const T& rhs) {
+		if (size()) {
+			front() |= static_cast<digit>(rhs);
+		} else {
+			*this = static_cast<digit>(rhs);
+		}
+		return *this;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator^(const T& rhs) const & {
+		uinteger_t result(*this);
+		return result ^= rhs;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator^(const T& rhs) && {
+		return std::move(*this ^= rhs);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator^=(const T& rhs) {
+		if (size()) {
+			front() ^= static_cast<digit>(rhs);
+			trim();
+		} else {
+			*this = static_cast<digit>(rhs);
+		}
+		return *this;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator==(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) == 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator!=(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) != 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator>(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) > 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator<(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) < 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator>=(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) >= 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	bool operator<=(const T& rhs) const {
+		return compare_1(*this, static_cast<digit>(rhs)) <= 0;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator+(const T& rhs) const & {
+		return add_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator+(const T& rhs) && {
+		return std::move(add_1(*this, static_cast<digit>(rhs)));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator+=(const T& rhs) {
+		return add_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator-(const T& rhs) const & {
+		return sub_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator-(const T& rhs) && {
+		return std::move(sub_1(*this, static_cast<digit>(rhs)));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator-=(const T& rhs) {
+		return sub_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator*(const T& rhs) const & {
+		return mult_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator*(const T& rhs) && {
+		return std::move(mult_1(*this, static_cast<digit>(rhs)));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator*=(const T& rhs) {
+		return mult_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator/(const T& rhs) const & {
+		return divmod_1(*this, static_cast<digit>(rhs)).first;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator/(const T& rhs) && {
+		return std::move(div_1(*this, static_cast<digit>(rhs)));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator/=(const T& rhs) {
+		return div_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t operator%(const T& rhs) const {
+		return mod_1(*this, static_cast<digit>(rhs));
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	uinteger_t& operator%=(const T& rhs) {
+		*this = mod_1(*this, static_cast<digit>(rhs));
+		return *this;
+	}
+
+	// native - uinteger_t, building only the result
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	friend uinteger_t operator-(const T& lhs, const uinteger_t& rhs) {
+		uinteger_t result;
+		sub_1(result, static_cast<digit>(lhs), rhs);
+		return result;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	friend uinteger_t operator-(const T& lhs, uinteger_t&& rhs) {
+		return std::move(sub_1(rhs, static_cast<digit>(lhs), rhs));
+	}
+
+	// Increment Operator
+	uinteger_t& operator++() {
+		return add_1(*this, 1);
+	}
+	uinteger_t operator++(int) {
+		uinteger_t temp(*this);
+		++*this;
+		return temp;
+	}
+
+	// Decrement Operator
+	uinteger_t& operator--() {
+		return sub_1(*this, 1);
+	}
+	uinteger_t operator--(int) {
+		uinteger_t temp(*this);
+		--*this;
+		return temp;
+	}
+
+	// Nothing done since promotion doesn't work here
+	uinteger_t operator+() const {
+		return *this;
+	}
+
+	// two's complement
+	uinteger_t operator-() const {
+		return uint_0() - *this;
+	}
+
+	// Get private value at index
+	const digit& value(std::size_t idx) const {
+		static const digit zero = 0;
+		return idx < size() ? *(begin() + idx) : zero;
+	}
+
+	// Get value of bit N
+	bool operator[](std::size_t n) const {
+		auto nd = n / digit_bits;
+		auto nm = n % digit_bits;
+		return nd < size() ? (*(begin() + nd) >> nm) & 1 : 0;
+	}
+
+	// Get bitsize of value
+	std::size_t bits() const {
+		auto sz = size();
+		if (sz) {
+			return _bits(back()) + (sz - 1) * digit_bits;
+		}
+		return 0;
+	}
+
+	// Get memory resource used by the digits storage
+	memory_resource* get_resource() const noexcept {
+		return _value.resource();
+	}
+
+private:
+	// Appends the characters of the (non-zero) value in a base that isn't a power
+	// of two, the least significant first
+	template <typename Result>
+	void _str_radix(Result& result, int alphabet_base) const {
+		// Divide and conquer, by chunk^(2^k) (the largest below the number,
+		// chunk being the largest power of the base in a digit) then by the
+		// smaller powers on both halves
+		auto num_sz = size();
+		std::vector<divisor> powers;
+		if (num_sz >= str_cutoff) {
+			uinteger_t power = base_chunk(alphabet_base);
+			while (2 * power.size() - 1 <= num_sz) {
+				auto next = sqr(power);
+				powers.emplace_back(std::move(power));
+				power = std::move(next);
+			}
+			powers.emplace_back(std::move(power));
+		}
+		_str(result, *this, alphabet_base, powers, powers.size(), 0);
+	}
+
+	// Output for _str_radix() writing backwards into a caller buffer, from last,
+	// so the characters come out in order
+	class reverse_chars {
+	public:
+		explicit reverse_chars(char* last) :
+			_last(last),
+			_size(0) { }
+
+		std::size_t size() const {
+			return _size;
+		}
+
+		char* begin() const {
+			return _last - _size;
+		}
+
+		void push_back(char c) {
+			*(_last - ++_size) = c;
+		}
+
+		void resize(std::size_t size, char c) {
+			while (_size < size) {
+				push_back(c);
+			}
+			_size = size;
+		}
+
+	private:
+		char* _last;
+		std::size_t _size;
+	};
+
+public:
+	// Number of characters of the value in the given base, exact for power of two
+	// bases and an upper bound (at most one over) otherwise
+	std::size_t chars_needed(int alphabet_base = 10) const {
+		if (alphabet_base < 2 || alphabet_base > 36) {
+			throw std::invalid_argument("Base must be in the range [2, 36]");
+		}
+		auto num_bits = bits();
+		if (!num_bits) {
+			return 1;
+		}
+		auto alphabet_base_bits = base_bits(alphabet_base);
+		if (alphabet_base_bits) {
+			return (num_bits + alphabet_base_bits - 1) / alphabet_base_bits;
+		}
+		// floor(bits log_base(2)) + 1, rounding the logarithm up
+		return static_cast<std::size_t>(num_bits * (std::log(2.0) / std::log(alphabet_base) + 1e-14)) + 1;
+	}
+
+	struct to_chars_result {
+		char* ptr;
+		std::errc ec;
+	};
+
+	struct from_chars_result {
+		const char* ptr;
+		std::errc ec;
+	};
+
+	// Writes the value into [first, last) without a terminating null, as
+	// std::to_chars(): returns the end of the characters written, or last and
+	// std::errc::value_too_large if they don't fit.
+	to_chars_result to_chars(char* first, char* last, int alphabet_base = 10) const {
+		auto needed = chars_needed(alphabet_base);
+		auto available = static_cast<std::size_t>(last - first);
+		if (!*this) {
+			if (!available) {
+				return {last, std::errc::value_too_large};
+			}
+			*first = chr(0);
+			return {first + 1, std::errc()};
+		}
+
+		auto alphabet_base_bits = base_bits(alphabet_base);
+		if (alphabet_base_bits) {
+			if (available < needed) {
+				return {last, std::errc::value_too_large};
+			}
+			digit alphabet_base_mask = alphabet_base - 1;
+			for (std::size_t i = 0; i < needed; ++i) {
+				auto d = static_cast<int>(_digit_at(*this, i * alphabet_base_bits) & alphabet_base_mask);
+				first[needed - 1 - i] = chr(d);
+			}
+			return {first + needed, std::errc()};
+		}
+
+		if (available >= needed) {
+			reverse_chars result(first + needed);
+			_str_radix(result, alphabet_base);
+			std::memmove(first, result.begin(), result.size());
+			return {first + result.size(), std::errc()};
+		}
+		// the upper bound doesn't fit, it could still fit exactly
+		auto result = str(alphabet_base);
+		if (available < result.size()) {
+			return {last, std::errc::value_too_large};
+		}
+		return {std::copy(result.begin(), result.end(), first), std::errc()};
+	}
+
+	// Parses the longest run of digits in the given base at first into value,
+	// as std::from_chars(): returns the end of the digits, or first and
+	// std::errc::invalid_argument if there are none (leaving value untouched).
+	static from_chars_result from_chars(const char* first, const char* last, uinteger_t& value, int alphabet_base = 10) {
+		if (alphabet_base < 2 || alphabet_base > 36) {
+			throw std::invalid_argument("Base must be in the range [2, 36]");
+		}
+		auto end = first;
+		for (; end != last; ++end) {
+			auto d = ord(static_cast<int>(*end));
+			if (d < 0 || d >= alphabet_base) {
+				break;
+			}
+		}
+		if (end == first) {
+			return {first, std::errc::invalid_argument};
+		}
+		value = strtouint(first, end - first, alphabet_base);
+		return {end, std::errc()};
+	}
+
+	// Get string representation of value
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result str(int alphabet_base = 10) const {
+		auto num_sz = size();
+		if (alphabet_base >= 2 && alphabet_base <= 36) {
+			Result result;
+			if (num_sz) {
+				auto alphabet_base_bits = base_bits(alphabet_base);
+				result.reserve(num_sz * base_size(alphabet_base));
+				if (alphabet_base_bits) {
+					digit alphabet_base_mask = alphabet_base - 1;
+					std::size_t shift = 0;
+					auto ptr = reinterpret_cast<const half_digit*>(data());
+					digit v = *ptr++;
+					v <<= half_digit_bits;
+					for (auto i = num_sz * 2 - 1; i; --i) {
+						v >>= half_digit_bits;
+						v |= (static_cast<digit>(*ptr++) << half_digit_bits);
+						do {
+							auto d = static_cast<int>((v >> shift) & alphabet_base_mask);
+							result.push_back(chr(d));
+							shift += alphabet_base_bits;
+						} while (shift <= half_digit_bits);
+						shift -= half_digit_bits;
+					}
+					v >>= (shift + half_digit_bits);
+					while (v) {
+						auto d = static_cast<int>(v & alphabet_base_mask);
+						result.push_back(chr(d));
+						v >>= alphabet_base_bits;
+					}
+					auto s = chr(0);
+					auto rit_f = std::find_if(result.rbegin(), result.rend(), [s](const char& c) { return c != s; });
+					result.resize(result.rend() - rit_f); // shrink
+				} else {
+					_str_radix(result, alphabet_base);
+				}
+				std::reverse(result.begin(), result.end());
+			} else {
+				result.push_back(chr(0));
+			}
+			return result;
+		} else if (alphabet_base == 256) {
+			if (num_sz) {
+				auto ptr = reinterpret_cast<const char*>(data());
+				Result result(ptr, ptr + num_sz * digit_octets);
+				auto rit_f = std::find_if(result.rbegin(), result.rend(), [](const char& c) { return c; });
+				result.resize(result.rend() - rit_f); // shrink
+				std::reverse(result.begin(), result.end());
+				return result;
+			} else {
+				Result result;
+				result.push_back('\x00');
+				return result;
+			}
+		} else {
+			throw std::invalid_argument("Base must be in the range [2, 36]");
+		}
+	}
+
+	static uinteger_t strtouint(const void* encoded, std::size_t encoded_size, int alphabet_base) {
+		const char* data = (const char *)encoded;
+		uinteger_t result;
+
+		if (alphabet_base >= 2 && alphabet_base <= 36) {
+			auto alphabet_base_bits = base_bits(alphabet_base);
+			if (alphabet_base_bits) {
+				_strtouint_bits(result, data, encoded_size, alphabet_base, alphabet_base_bits);
+			} else {
+				// Divide and conquer above strtouint_cutoff digits, with the powers
+				// chunk^(2^k) up to half the size of the result
+				std::size_t chunk_size = base_chunk_size(alphabet_base);
+				std::vector<uinteger_t> powers;
+				if ((encoded_size + chunk_size - 1) / chunk_size >= strtouint_cutoff) {
+					powers.emplace_back(base_chunk(alphabet_base));
+					while ((chunk_size << powers.size()) < encoded_size) {
+						powers.emplace_back(sqr(powers.back()));
+					}
+				}
+				_strtouint(result, data, encoded_size, alphabet_base, powers, powers.size(), data + encoded_size);
+			}
+		} else if (encoded_size && alphabet_base == 256) {
+			auto value_size = encoded_size / digit_octets;
+			auto value_padding = encoded_size % digit_octets;
+			if (value_padding) {
+				value_padding = digit_octets - value_padding;
+				++value_size;
+			}
+			result.resize(value_size); // grow (no initialization)
+			*result.begin() = 0; // initialize value
+			auto ptr = reinterpret_cast<char*>(result.data());
+			std::copy(data, data + encoded_size, ptr + value_padding);
+			std::reverse(ptr, ptr + value_size * digit_octets);
+		} else {
+			throw std::invalid_argument("Error: Cannot convert from base " + std::to_string(alphabet_base));
+		}
+
+		return result;
+	}
+
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result bin() const {
+		return str<Result>(2);
+	}
+
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result oct() const {
+		return str<Result>(8);
+	}
 
-	uinteger_t(const uinteger_t& o) :
-		_begin(0),
-		_end(0),
-		_value_instance(o.begin(), o.end()),
-		_value(_value_instance),
-		_carry(o._carry) { }
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result hex() const {
+		return str<Result>(16);
+	}
 
-	uinteger_t(uinteger_t&& o) :
-		_begin(std::move(o._begin)),
-		_end(std::move(o._end)),
-		_value_instance(std::move(o._value_instance)),
-		_value(_value_instance),
-		_carry(std::move(o._carry)) { }
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result raw() const {
+		return str<Result>(256);
+	}
+};
 
-	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-	uinteger_t(const T& value) :
-		_begin(0),
-		_end(0),
-		_value(_value_instance),
-		_carry(false) {
-		if (value) {
-			append(static_cast<digit>(value));
+class uinteger_t::divisor {
+public:
+	explicit divisor(const uinteger_t& value) :
+		_value(value) {
+		if (!_value) {
+			throw std::domain_error("Error: division or modulus by 0");
+		}
+		_shift = digit_bits - _bits(_value.back());
+		_normalized = _value << _shift;
+		if (_normalized.size() == 1) {
+			_inverse = _reciprocal(_normalized.front());
+		} else {
+			_inverse = _reciprocal(*_normalized.rbegin(), *(_normalized.rbegin() + 1));
 		}
 	}
 
-	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-	uinteger_t(const T& value, Args... args) :
-		_begin(0),
-		_end(0),
-		_value(_value_instance),
-		_carry(false) {
-		_uint_t(args...);
-		append(static_cast<digit>(value));
-		trim();
+	const uinteger_t& value() const {
+		return _value;
 	}
 
-	template <typename T, typename... Args, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-	uinteger_t(std::initializer_list<T> list) :
-		_begin(0),
-		_end(0),
-		_value(_value_instance),
-		_carry(false) {
-		reserve(list.size());
-		for (const auto& value : list) {
-			append(static_cast<digit>(value));
+private:
+	friend class uinteger_t;
+
+	uinteger_t _value;       // the divisor
+	uinteger_t _normalized;  // the divisor shifted left so its top bit is set
+	std::size_t _shift;      // bits shifted
+	digit _inverse;          // reciprocal of its top digit (or top two digits)
+};
+
+inline std::pair<std::reference_wrapper<uinteger_t>, std::reference_wrapper<uinteger_t>> uinteger_t::divmod(uinteger_t& quotient, uinteger_t& remainder, const uinteger_t& lhs, const divisor& rhs) {
+	auto lhs_sz = lhs.size();
+	auto rhs_sz = rhs._value.size();
+	if (compare(lhs, rhs._value) < 0) {
+		quotient = uint_0();
+		remainder = lhs;
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+	if (rhs_sz == 1) {
+		auto u = lhs << rhs._shift;
+		uinteger_t q;
+		q.resize(u.size());
+		auto r = _divmod_1(q.data(), u.data(), u.size(), rhs._normalized.front(), rhs._inverse);
+		q.trim();
+		quotient = std::move(q);
+		remainder = static_cast<digit>(r >> rhs._shift);
+		return std::make_pair(std::ref(quotient), std::ref(remainder));
+	}
+	if (rhs_sz >= burnikel_ziegler_cutoff && lhs_sz - rhs_sz >= burnikel_ziegler_cutoff) {
+		// Setup is negligible for these
+		return divmod(quotient, remainder, lhs, rhs._value);
+	}
+
+	return knuth_divmod(quotient, remainder, lhs, rhs._normalized, rhs._shift, rhs._inverse);
+}
+
+// Appends the characters of num (below chunk^(2^k)) to result, the least
+// significant first, padded with zeros up to width characters.
+template <typename Result>
+inline void uinteger_t::_str(Result& result, const uinteger_t& num, int alphabet_base, const std::vector<divisor>& powers, std::size_t k, std::size_t width) {
+	auto start = result.size();
+	if (k == 0 || num.size() < str_cutoff) {
+		// Peels off as many characters as fit in a digit per division
+		auto chunk = base_chunk(alphabet_base);
+		auto chunk_size = base_chunk_size(alphabet_base);
+		uinteger_t quotient = num;
+		auto data = quotient.data();
+		auto n = quotient.size();
+		while (n) {
+			auto c = _divrem_1(data, data, n, chunk);
+			if (!data[n - 1]) {
+				--n;
+			}
+			if (!n && !width) {
+				// the most significant chunk, without leading zeros
+				for (; c; c /= alphabet_base) {
+					result.push_back(chr(static_cast<int>(c % alphabet_base)));
+				}
+			} else {
+				_str_chunk(result, c, alphabet_base, chunk_size);
+			}
 		}
-		trim();
+	} else if (!width && compare(num, powers[k - 1].value()) < 0) {
+		// the most significant part, without leading zeros
+		_str(result, num, alphabet_base, powers, k - 1, 0);
+	} else {
+		// num = q chunk^(2^(k-1)) + r
+		uinteger_t quotient, remainder;
+		divmod(quotient, remainder, num, powers[k - 1]);
+		_str(result, remainder, alphabet_base, powers, k - 1, base_chunk_size(alphabet_base) << (k - 1));
+		_str(result, quotient, alphabet_base, powers, k - 1, 0);
+	}
+	if (width) {
+		result.resize(start + width, chr(0));
 	}
+}
 
-	template <typename T, std::size_t N>
-	explicit uinteger_t(T (&s)[N], int base=10) :
-		uinteger_t(s, N - 1, base) { }
+inline std::pair<uinteger_t, uinteger_t> uinteger_t::divmod(const uinteger_t& lhs, const divisor& rhs) {
+	uinteger_t quotient;
+	uinteger_t remainder;
+	divmod(quotient, remainder, lhs, rhs);
+	return std::make_pair(std::move(quotient), std::move(remainder));
+}
 
-	explicit uinteger_t(const unsigned char* bytes, std::size_t sz, int base) :
-		uinteger_t(strtouint(bytes, sz, base)) { }
+inline std::pair<uinteger_t, uinteger_t> uinteger_t::divmod(const divisor& rhs) const {
+	return divmod(*this, rhs);
+}
 
-	explicit uinteger_t(const char* bytes, std::size_t sz, int base) :
-		uinteger_t(strtouint(bytes, sz, base)) { }
+inline uinteger_t uinteger_t::operator/(const divisor& rhs) const {
+	return divmod(*this, rhs).first;
+}
 
-	template <typename T>
-	explicit uinteger_t(const std::vector<T>& bytes, int base=10) :
-		uinteger_t(bytes.data(), bytes.size(), base) { }
+inline uinteger_t& uinteger_t::operator/=(const divisor& rhs) {
+	uinteger_t quotient;
+	uinteger_t remainder;
+	divmod(quotient, remainder, *this, rhs);
+	*this = std::move(quotient);
+	return *this;
+}
 
-	explicit uinteger_t(const std::string& bytes, int base=10) :
-		uinteger_t(bytes.data(), bytes.size(), base) { }
+inline uinteger_t uinteger_t::operator%(const divisor& rhs) const {
+	return divmod(*this, rhs).second;
+}
 
-	// Assignment Operator
-	uinteger_t& operator=(const uinteger_t& o) {
-		_begin = 0;
-		_end = 0;
-		_value = container(o.begin(), o.end());
-		_carry = o._carry;
-		return *this;
+inline uinteger_t& uinteger_t::operator%=(const divisor& rhs) {
+	uinteger_t quotient;
+	uinteger_t remainder;
+	divmod(quotient, remainder, *this, rhs);
+	*this = std::move(remainder);
+	return *this;
+}
+
+// Numbers in Montgomery form are kept as a R mod m (with R = 2^(digit_bits n),
+// n being the number of digits in the modulus), so products only need a
+// Montgomery reduction instead of a division. The kernels work on buffers of
+// exactly size() digits and need scratch_size() scratch digits, so a whole
+// computation can run on preallocated buffers; the uinteger_t overloads
+// allocate their own.
+class uinteger_t::montgomery_ctx {
+public:
+	explicit montgomery_ctx(const uinteger_t& modulus) :
+		_modulus(modulus) {
+		if (!_modulus || !(_modulus.front() & 1)) {
+			throw std::domain_error("Error: Montgomery modulus must be odd");
+		}
+		_n = _modulus.size();
+		_inverse = _montgomery_inverse(_modulus.front());
+		_r2 = (uint_1() << (2 * digit_bits * _n)) % _modulus;
+		_r2.resize(_n, 0);  // kept padded to n digits
 	}
-	uinteger_t& operator=(uinteger_t&& o) {
-		_begin = std::move(o._begin);
-		_end = std::move(o._end);
-		_value_instance = std::move(o._value_instance);
-		_carry = std::move(o._carry);
-		return *this;
+
+	const uinteger_t& modulus() const {
+		return _modulus;
 	}
 
-	// Typecast Operators
-	explicit operator bool() const {
-		return static_cast<bool>(size());
+	// Number of digits in the kernels' buffers
+	std::size_t size() const {
+		return _n;
 	}
-	explicit operator unsigned char() const {
-		return static_cast<unsigned char>(size() ? front() : 0);
+
+	// Number of scratch digits needed by the kernels
+	std::size_t scratch_size() const {
+		return _montgomery_scratch(_n);
 	}
-	explicit operator unsigned short() const {
-		return static_cast<unsigned short>(size() ? front() : 0);
+
+	// r = a R mod m (r can be a)
+	void to_montgomery(digit* r, const digit* a, digit* scratch) const {
+		_montgomery_mult(r, a, _r2.data(), _modulus.data(), _n, _inverse, scratch);
 	}
-	explicit operator unsigned int() const {
-		return static_cast<unsigned int>(size() ? front() : 0);
+
+	// r = a R^-1 mod m (r can be a)
+	void from_montgomery(digit* r, const digit* a, digit* scratch) const {
+		std::copy(a, a + _n, scratch);
+		std::fill_n(scratch + _n, _n, 0);
+		_montgomery_reduce(r, scratch, _modulus.data(), _n, _inverse);
 	}
-	explicit operator unsigned long() const {
-		return static_cast<unsigned long>(size() ? front() : 0);
+
+	// r = a b R^-1 mod m (r can be a or b)
+	void mult(digit* r, const digit* a, const digit* b, digit* scratch) const {
+		if (a == b) {
+			_montgomery_sqr(r, a, _modulus.data(), _n, _inverse, scratch);
+		} else {
+			_montgomery_mult(r, a, b, _modulus.data(), _n, _inverse, scratch);
+		}
 	}
-	explicit operator unsigned long long() const {
-		return static_cast<unsigned long long>(size() ? front() : 0);
+
+	// r = a^2 R^-1 mod m (r can be a)
+	void sqr(digit* r, const digit* a, digit* scratch) const {
+		_montgomery_sqr(r, a, _modulus.data(), _n, _inverse, scratch);
 	}
-	explicit operator char() const {
-		return static_cast<char>(size() ? front() : 0);
+
+	uinteger_t to_montgomery(const uinteger_t& a) const {
+		uinteger_t result;
+		result.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		to_montgomery(result.data(), _load(a, result), scratch.data());
+		result.trim();
+		return result;
 	}
-	explicit operator short() const {
-		return static_cast<short>(size() ? front() : 0);
+
+	uinteger_t from_montgomery(const uinteger_t& a) const {
+		uinteger_t result;
+		result.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		from_montgomery(result.data(), _load(a, result), scratch.data());
+		result.trim();
+		return result;
 	}
-	explicit operator int() const {
-		return static_cast<int>(size() ? front() : 0);
+
+	uinteger_t mult(const uinteger_t& a, const uinteger_t& b) const {
+		uinteger_t result;
+		result.resize(_n);
+		uinteger_t tmp;
+		tmp.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		mult(result.data(), _load(a, result), _load(b, tmp), scratch.data());
+		result.trim();
+		return result;
 	}
-	explicit operator long() const {
-		return static_cast<long>(size() ? front() : 0);
+
+	uinteger_t sqr(const uinteger_t& a) const {
+		uinteger_t result;
+		result.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		sqr(result.data(), _load(a, result), scratch.data());
+		result.trim();
+		return result;
 	}
-	explicit operator long long() const {
-		return static_cast<long long>(size() ? front() : 0);
+
+	// a b mod m, for numbers in the usual form
+	// (a b R^-1 R^2 R^-1 = a b, so it takes no conversions)
+	uinteger_t mulmod(const uinteger_t& a, const uinteger_t& b) const {
+		uinteger_t result;
+		result.resize(_n);
+		uinteger_t tmp;
+		tmp.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		auto r = result.data();
+		mult(r, _load(a, result), _load(b, tmp), scratch.data());
+		_montgomery_mult(r, r, _r2.data(), _modulus.data(), _n, _inverse, scratch.data());
+		result.trim();
+		return result;
 	}
 
-	// Bitwise Operators
-	uinteger_t operator&(const uinteger_t& rhs) const {
-		return bitwise_and(*this, rhs);
+private:
+	// Copies a mod m into buf (already sized to n digits)
+	const digit* _load(const uinteger_t& a, uinteger_t& buf) const {
+		auto data = buf.data();
+		if (compare(a, _modulus) < 0) {
+			std::fill(std::copy(a.begin(), a.end(), data), data + _n, 0);
+		} else {
+			auto r = a % _modulus;
+			std::fill(std::copy(r.begin(), r.end(), data), data + _n, 0);
+		}
+		return data;
 	}
 
-	uinteger_t& operator&=(const uinteger_t& rhs) {
-		return bitwise_and(*this, rhs);
+	friend class uinteger_t;
+
+	uinteger_t _modulus;  // the (odd) modulus
+	std::size_t _n;       // digits in the modulus
+	digit _inverse;       // -m^-1 mod 2^digit_bits
+	uinteger_t _r2;       // R^2 mod m
+};
+
+// Barrett reduction replaces the division by m with two multiplications, by
+// mu = floor(b^(2 n) / m) (b = 2^digit_bits, n being the number of digits in
+// the modulus) and by m, for numbers of up to 2 n digits. Like montgomery_ctx, the
+// kernels work on buffers of exactly size() digits with scratch_size()
+// scratch digits, and the uinteger_t overloads allocate their own.
+class uinteger_t::barrett_ctx {
+public:
+	explicit barrett_ctx(const uinteger_t& modulus) :
+		_modulus(modulus) {
+		if (!_modulus) {
+			throw std::domain_error("Error: division or modulus by 0");
+		}
+		_n = _modulus.size();
+		_mu = (uint_1() << (2 * digit_bits * _n)) / _modulus;
 	}
 
-	uinteger_t operator|(const uinteger_t& rhs) const {
-		return bitwise_or(*this, rhs);
+	const uinteger_t& modulus() const {
+		return _modulus;
 	}
 
-	uinteger_t& operator|=(const uinteger_t& rhs) {
-		return bitwise_or(*this, rhs);
+	// Number of digits in the kernels' buffers
+	std::size_t size() const {
+		return _n;
 	}
 
-	uinteger_t operator^(const uinteger_t& rhs) const {
-		return bitwise_xor(*this, rhs);
+	// Number of scratch digits needed by the kernels
+	std::size_t scratch_size() const {
+		auto mu_sz = _mu.size();
+		auto q_sz = _n + 1;  // digits in x / b^(n - 1), for x of 2 n digits
+		auto reduce_sz = (q_sz + mu_sz) + (2 * _n + 1) + (_n + 1) +
+			std::max(_karatsuba_scratch(q_sz, mu_sz, karatsuba_cutoff), _karatsuba_scratch(q_sz, _n, karatsuba_cutoff));
+		return 2 * _n + std::max({reduce_sz, _karatsuba_scratch(_n, _n, karatsuba_cutoff), _karatsuba_sqr_scratch(_n, karatsuba_cutoff)});
 	}
 
-	uinteger_t& operator^=(const uinteger_t& rhs) {
-		return bitwise_xor(*this, rhs);
+	// r = x mod m, for x of xn <= 2 n digits, r gets n digits
+	void reduce(digit* r, const digit* x, std::size_t xn, digit* scratch) const {
+		ASSERT(xn <= 2 * _n);
+		auto n = _n;
+		auto m = _modulus.data();
+		if (xn < n) {
+			std::fill(std::copy(x, x + xn, r), r + n, 0);
+			return;
+		}
+
+		// q = (x / b^(n - 1)) mu / b^(n + 1), which is at most 2 below x / m
+		auto q1 = x + n - 1;
+		auto q1n = xn - (n - 1);
+		auto mu_sz = _mu.size();
+		auto q2 = scratch;
+		auto q2n = q1n + mu_sz;
+		auto p = q2 + q2n;
+		auto rr = p + 2 * n + 1;
+		auto t = rr + n + 1;
+		_karatsuba_mult(q2, q1, q1n, _mu.data(), mu_sz, t, karatsuba_cutoff);
+		auto q3 = q2 + n + 1;
+		auto q3n = q2n > n + 1 ? q2n - (n + 1) : 0;
+		for (; q3n && !q3[q3n - 1]; --q3n);
+
+		// r = x - q m, only its low n + 1 digits are needed
+		std::fill(std::copy(x, x + std::min(xn, n + 1), rr), rr + n + 1, 0);
+		if (q3n) {
+			if (std::min(q3n, n) < karatsuba_cutoff) {
+				_long_mult_lo(p, q3, q3n, m, n, n + 1);
+			} else {
+				_karatsuba_mult(p, q3, q3n, m, n, t, karatsuba_cutoff);
+			}
+			_sub(rr, rr, n + 1, p, n + 1);
+		}
+		while (_cmp(rr, n + 1, m, n) >= 0) {
+			_sub(rr, rr, n + 1, m, n);
+		}
+		std::copy(rr, rr + n, r);
 	}
 
-	uinteger_t operator~() const {
-		return bitwise_inv(*this);
+	// r = a b mod m, for a, b < m (r can be a or b)
+	void mult(digit* r, const digit* a, const digit* b, digit* scratch) const {
+		if (a == b) {
+			_karatsuba_sqr(scratch, a, _n, scratch + 2 * _n, karatsuba_cutoff);
+		} else {
+			_karatsuba_mult(scratch, a, _n, b, _n, scratch + 2 * _n, karatsuba_cutoff);
+		}
+		reduce(r, scratch, 2 * _n, scratch + 2 * _n);
 	}
 
-	uinteger_t inv() {
-		return bitwise_inv(*this);
+	// r = a^2 mod m, for a < m (r can be a)
+	void sqr(digit* r, const digit* a, digit* scratch) const {
+		_karatsuba_sqr(scratch, a, _n, scratch + 2 * _n, karatsuba_cutoff);
+		reduce(r, scratch, 2 * _n, scratch + 2 * _n);
 	}
 
-	// Bit Shift Operators
-	uinteger_t operator<<(const uinteger_t& rhs) const {
-		return bitwise_lshift(*this, rhs);
+	// x mod m, numbers of more than 2 n digits take a regular division
+	uinteger_t reduce(const uinteger_t& x) const {
+		auto x_sz = x.size();
+		if (x_sz > 2 * _n) {
+			return x % _modulus;
+		}
+		uinteger_t result;
+		result.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		reduce(result.data(), x.data(), x_sz, scratch.data());
+		result.trim();
+		return result;
+	}
+
+	uinteger_t mulmod(const uinteger_t& a, const uinteger_t& b) const {
+		uinteger_t result;
+		result.resize(_n);
+		uinteger_t tmp;
+		tmp.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		mult(result.data(), _load(a, result), _load(b, tmp), scratch.data());
+		result.trim();
+		return result;
+	}
+
+	uinteger_t sqrmod(const uinteger_t& a) const {
+		uinteger_t result;
+		result.resize(_n);
+		container scratch;
+		scratch.resize(scratch_size());
+		sqr(result.data(), _load(a, result), scratch.data());
+		result.trim();
+		return result;
+	}
+
+private:
+	friend class uinteger_t;
+
+	// Copies a mod m into buf (already sized to n digits)
+	const digit* _load(const uinteger_t& a, uinteger_t& buf) const {
+		auto data = buf.data();
+		if (compare(a, _modulus) < 0) {
+			std::fill(std::copy(a.begin(), a.end(), data), data + _n, 0);
+		} else {
+			auto r = reduce(a);
+			std::fill(std::copy(r.begin(), r.end(), data), data + _n, 0);
+		}
+		return data;
+	}
+
+	uinteger_t _modulus;  // the modulus
+	std::size_t _n;       // digits in the modulus
+	uinteger_t _mu;       // floor(b^(2 n) / m)
+};
+
+// The table of odd powers and the result are kept in Montgomery form
+inline uinteger_t uinteger_t::powmod(const uinteger_t& base, const uinteger_t& exp, const montgomery_ctx& ctx) {
+	if (compare_1(ctx._modulus, 1) == 0) {
+		return uint_0();
+	}
+	if (!exp) {
+		return uint_1();
+	}
+
+	auto n = ctx._n;
+	auto k = _window_bits(exp.bits());
+
+	uinteger_t result;
+	result.resize(n);
+	container buffer;
+	buffer.resize(((1 << (k - 1)) + 1) * n + ctx.scratch_size());
+	auto table = buffer.data();
+	auto scratch = table + ((1 << (k - 1)) + 1) * n;
+
+	auto r = result.data();
+	ctx.to_montgomery(table, ctx._load(base, result), scratch);
+	_powmod(r, table, exp, k, ctx, scratch);
+	ctx.from_montgomery(r, r, scratch);
+
+	result.trim();
+	return result;
+}
+
+inline uinteger_t uinteger_t::powmod(const uinteger_t& base, const uinteger_t& exp, const barrett_ctx& ctx) {
+	if (compare_1(ctx._modulus, 1) == 0) {
+		return uint_0();
+	}
+	if (!exp) {
+		return uint_1();
+	}
+
+	auto n = ctx._n;
+	auto k = _window_bits(exp.bits());
+
+	uinteger_t result;
+	result.resize(n);
+	container buffer;
+	buffer.resize(((1 << (k - 1)) + 1) * n + ctx.scratch_size());
+	auto table = buffer.data();
+	auto scratch = table + ((1 << (k - 1)) + 1) * n;
+
+	auto r = result.data();
+	auto b = ctx._load(base, result);
+	std::copy(b, b + n, table);
+	_powmod(r, table, exp, k, ctx, scratch);
+
+	result.trim();
+	return result;
+}
+
+// Odd moduli use Montgomery products, even ones Barrett reduction
+inline uinteger_t uinteger_t::powmod(const uinteger_t& base, const uinteger_t& exp, const uinteger_t& mod) {
+	if (!mod) {
+		throw std::domain_error("Error: division or modulus by 0");
+	}
+	if (mod.front() & 1) {
+		return powmod(base, exp, montgomery_ctx(mod));
+	}
+	return powmod(base, exp, barrett_ctx(mod));
+}
+
+struct uinteger_t::cofactors {
+	uinteger_t a;    // magnitude of the coefficient in a
+	uinteger_t b;    // magnitude of the coefficient in b
+	bool negative;   // the coefficient in a is negative (and the one in b isn't)
+	uinteger_t tmp;  // scratch
+	uinteger_t tmp2;
+};
+
+struct uinteger_t::hgcd_matrix {
+	uinteger_t m00;
+	uinteger_t m01;
+	uinteger_t m10;
+	uinteger_t m11;
+};
+
+// Bezout coefficients, the magnitudes of x and y in a x + b y = gcd (they
+// always have opposite signs): gcd = a x - b y, or b y - a x if x_negative.
+struct uinteger_t::bezout {
+	uinteger_t gcd;
+	uinteger_t x;
+	uinteger_t y;
+	bool x_negative;
+};
+
+// (a, b) = (b, a mod b)
+inline void uinteger_t::_euclid_step(uinteger_t& a, uinteger_t& b, uinteger_t& quotient, uinteger_t& remainder, cofactors* co) {
+	divmod(quotient, remainder, a, b);
+	std::swap(a, b);
+	std::swap(b, remainder);
+	if (co) {
+		addmul(co->a, quotient, co->b);
+		std::swap(co->a, co->b);
+		co->negative = !co->negative;
 	}
+}
+
+// Lehmer's cofactors, for a >= b > 0 and a of at least two digits: runs
+// Euclid's algorithm on the top bits of a and b for as long as its quotients
+// are the same ones a and b would get, accumulating them in the cofactors
+// A, B, C and D (which fit in half a digit), so that after k steps
+//   (a, b) = (A a - B b, D b - C a) if k is even,
+//            (A b - B a, D a - C b) if k is odd.
+// Returns k, the number of steps.
+inline std::size_t uinteger_t::_lehmer(const uinteger_t& a, const uinteger_t& b, digit (&cofactors)[4]) {
+	using sdigit = typename std::make_signed<digit>::type;
+
+	// a few bits of room keep the signed arithmetic below from overflowing
+	auto shift = a.bits() - (digit_bits - 4);
+	auto x = static_cast<sdigit>(_digit_at(a, shift));
+	auto y = static_cast<sdigit>(_digit_at(b, shift));
+
+	sdigit A = 1, B = 0, C = 0, D = 1;
+	std::size_t k = 0;
+	for (;; ++k) {
+		if (y - C == 0) {
+			break;
+		}
+		auto q = (x + (A - 1)) / (y - C);
+		auto s = B + q * D;
+		auto t = x - q * y;
+		if (s > t) {
+			break;
+		}
+		x = y;
+		y = t;
+		t = A + q * C;
+		A = D;
+		B = C;
+		C = s;
+		D = t;
+	}
+	cofactors[0] = static_cast<digit>(A);
+	cofactors[1] = static_cast<digit>(B);
+	cofactors[2] = static_cast<digit>(C);
+	cofactors[3] = static_cast<digit>(D);
+	return k;
+}
 
-	uinteger_t& operator<<=(const uinteger_t& rhs) {
-		return bitwise_lshift(*this, rhs);
-	}
+// result = p u - q v, for a non-negative result and u and v of n digits
+inline void uinteger_t::_lehmer_combine(uinteger_t& result, const uinteger_t& u, digit p, const uinteger_t& v, digit q, std::size_t n) {
+	result.resize(n + 1);
+	auto data = result.data();
+	data[n] = _mul_1(data, u.data(), n, p);
+	data[n] -= _submul_1(data, v.data(), n, q);
+	result.trim();
+}
 
-	uinteger_t operator>>(const uinteger_t& rhs) const {
-		return bitwise_rshift(*this, rhs);
+// Lehmer's step, for a >= b > 0 and a of at least two digits: applies
+// Lehmer's cofactors to a and b, with single digit multiplications.
+// Returns false if no step could be taken.
+inline bool uinteger_t::_lehmer_step(uinteger_t& a, uinteger_t& b, uinteger_t& c, uinteger_t& d, cofactors* co) {
+	digit m[4];
+	auto k = _lehmer(a, b, m);
+	if (!k) {
+		return false;
+	}
+
+	auto n = a.size();
+	b.resize(n, 0);
+	auto& p = k & 1 ? b : a;
+	auto& r = k & 1 ? a : b;
+	_lehmer_combine(c, p, m[0], r, m[1], n);
+	_lehmer_combine(d, r, m[3], p, m[2], n);
+	std::swap(a, c);
+	std::swap(b, d);
+
+	if (co) {
+		auto& sp = k & 1 ? co->b : co->a;
+		auto& sr = k & 1 ? co->a : co->b;
+		mult_1(co->tmp, sp, m[0]);
+		addmul_1(co->tmp, sr, m[1]);
+		mult_1(co->tmp2, sr, m[3]);
+		addmul_1(co->tmp2, sp, m[2]);
+		std::swap(co->a, co->tmp);
+		std::swap(co->b, co->tmp2);
+		if (k & 1) {
+			co->negative = !co->negative;
+		}
 	}
+	return true;
+}
 
-	uinteger_t& operator>>=(const uinteger_t& rhs) {
-		return bitwise_rshift(*this, rhs);
-	}
+// Lehmer's step for the half-GCD, only taken if it leaves both a and b above
+// B^s; a and b keep their places (the larger one is the one reduced).
+inline bool uinteger_t::_hgcd_lehmer_step(uinteger_t& a, uinteger_t& b, std::size_t s, hgcd_matrix& m, uinteger_t& c, uinteger_t& d) {
+	bool swapped = compare(a, b) < 0;
+	auto& x = swapped ? b : a;
+	auto& y = swapped ? a : b;
+	if (x.size() < 2) {
+		return false;
+	}
+	digit cf[4];
+	auto k = _lehmer(x, y, cf);
+	if (!k) {
+		return false;
+	}
+
+	// even k: (a, b) = (A a - B b, D b - C a), M = M (D B; C A)
+	// odd k:  (a, b) = (D a - C b, A b - B a), M = M (A C; B D)
+	// (or the other way around if b was the larger)
+	auto n = x.size();
+	a.resize(n, 0);
+	b.resize(n, 0);
+	bool even = ((k & 1) == 0) != swapped;
+	auto A = cf[0], B = cf[1], C = cf[2], D = cf[3];
+	if (!even) {
+		std::swap(A, D);
+		std::swap(B, C);
+	}
+	_lehmer_combine(c, a, A, b, B, n);
+	_lehmer_combine(d, b, D, a, C, n);
+	if (!_above(c, s) || !_above(d, s)) {
+		a.trim();
+		b.trim();
+		return false;
+	}
+	std::swap(a, c);
+	std::swap(b, d);
+
+	// (m00 m01; m10 m11) (D B; C A)
+	mult_1(c, m.m00, D);
+	addmul_1(c, m.m01, C);
+	mult_1(d, m.m00, B);
+	addmul_1(d, m.m01, A);
+	std::swap(m.m00, c);
+	std::swap(m.m01, d);
+	mult_1(c, m.m10, D);
+	addmul_1(c, m.m11, C);
+	mult_1(d, m.m10, B);
+	addmul_1(d, m.m11, A);
+	std::swap(m.m10, c);
+	std::swap(m.m11, d);
+	return true;
+}
 
-	// Logical Operators
-	bool operator!() const {
-		return !static_cast<bool>(*this);
-	}
+// One step of Möller's half-GCD reduction: subtracts from the larger of a and
+// b the largest multiple of the smaller one which leaves it above B^s (bound
+// is B^s + 1), and updates M. Returns false when |a - b| <= B^s.
+inline bool uinteger_t::_hgcd_step(uinteger_t& a, uinteger_t& b, std::size_t s, const uinteger_t& bound, hgcd_matrix& m, uinteger_t& q, uinteger_t& r) {
+	bool swapped = compare(a, b) < 0;
+	auto& x = swapped ? b : a;
+	auto& y = swapped ? a : b;
+	sub(r, x, y);
+	if (!_above(r, s)) {
+		return false;
+	}
+
+	// q = (x - B^s - 1) / y
+	uinteger_t t;
+	sub(t, x, bound);
+	divmod(q, r, t, y);
+	submul(x, q, y);
+	if (swapped) {
+		addmul(m.m00, q, m.m01);
+		addmul(m.m10, q, m.m11);
+	} else {
+		addmul(m.m01, q, m.m00);
+		addmul(m.m11, q, m.m10);
+	}
+	return true;
+}
 
-	bool operator&&(const uinteger_t& rhs) const {
-		return static_cast<bool>(*this) && rhs;
-	}
+// (a, b) = M^-1 (a, b) = (m11 a - m01 b, m00 b - m10 a)
+inline void uinteger_t::_hgcd_apply(uinteger_t& a, uinteger_t& b, const hgcd_matrix& m, uinteger_t& c, uinteger_t& d) {
+	mult(c, m.m11, a);
+	submul(c, m.m01, b);
+	mult(d, m.m00, b);
+	submul(d, m.m10, a);
+	std::swap(a, c);
+	std::swap(b, d);
+}
 
-	bool operator||(const uinteger_t& rhs) const {
-		return static_cast<bool>(*this) || rhs;
-	}
+// Half-GCD, reduces a and b (of up to n digits) while both stay above B^s,
+// with s = n / 2 + 1, and returns the matrix of the reductions. Instead of
+// running every step on the whole numbers, the top half of them is reduced
+// recursively first, and then the top half of what remains.
+// (N. Möller, On Schönhage's algorithm and subquadratic integer GCD
+// computation, Math. Comp. 77 (2008)). Returns false if there was no
+// reduction (M is the identity).
+inline bool uinteger_t::_hgcd(uinteger_t& a, uinteger_t& b, hgcd_matrix& m) {
+	auto n = std::max(a.size(), b.size());
+	auto s = n / 2 + 1;
+	m.m00 = uint_1();
+	m.m01 = uint_0();
+	m.m10 = uint_0();
+	m.m11 = uint_1();
+	if (!_above(a, s) || !_above(b, s)) {
+		return false;
+	}
+
+	auto bound = (uint_1() << (s * digit_bits)) + 1;
+	uinteger_t q, r;
+	bool reduced = false;
+	if (n >= hgcd_cutoff) {
+		// The top half (above p digits) reduces the whole numbers as well,
+		// keeping them above B^s since p + (n - p) / 2 >= s:
+		auto p = n / 2;
+		auto a_hi = a >> (p * digit_bits);
+		auto b_hi = b >> (p * digit_bits);
+		hgcd_matrix m1;
+		if (_hgcd(a_hi, b_hi, m1)) {
+			_hgcd_apply(a, b, m1, q, r);
+			m = std::move(m1);
+			reduced = true;
+		}
 
-	// Comparison Operators
-	bool operator==(const uinteger_t& rhs) const {
-		return compare(*this, rhs) == 0;
-	}
+		while (std::max(a.size(), b.size()) > 3 * n / 4 + 1) {
+			if (!_hgcd_lehmer_step(a, b, s, m, q, r) && !_hgcd_step(a, b, s, bound, m, q, r)) {
+				return reduced;
+			}
+			reduced = true;
+		}
 
-	bool operator!=(const uinteger_t& rhs) const {
-		return compare(*this, rhs) != 0;
+		// And so does the top part of what remains, above p = 2 s - n' + 1 digits:
+		auto nn = std::max(a.size(), b.size());
+		if (nn > s + 2) {
+			p = 2 * s - nn + 1;
+			a_hi = a >> (p * digit_bits);
+			b_hi = b >> (p * digit_bits);
+			hgcd_matrix m2;
+			if (_hgcd(a_hi, b_hi, m2)) {
+				_hgcd_apply(a, b, m2, q, r);
+				// M = M M2
+				mult(q, m.m00, m2.m00);
+				addmul(q, m.m01, m2.m10);
+				mult(r, m.m00, m2.m01);
+				addmul(r, m.m01, m2.m11);
+				std::swap(m.m00, q);
+				std::swap(m.m01, r);
+				mult(q, m.m10, m2.m00);
+				addmul(q, m.m11, m2.m10);
+				mult(r, m.m10, m2.m01);
+				addmul(r, m.m11, m2.m11);
+				std::swap(m.m10, q);
+				std::swap(m.m11, r);
+				reduced = true;
+			}
+		}
 	}
 
-	bool operator>(const uinteger_t& rhs) const {
-		return compare(*this, rhs) > 0;
+	while (_hgcd_lehmer_step(a, b, s, m, q, r)) {
+		reduced = true;
 	}
-
-	bool operator<(const uinteger_t& rhs) const {
-		return compare(*this, rhs) < 0;
+	while (_hgcd_step(a, b, s, bound, m, q, r)) {
+		reduced = true;
 	}
+	return reduced;
+}
 
-	bool operator>=(const uinteger_t& rhs) const {
-		return compare(*this, rhs) >= 0;
+// Reduces (a, b), for a >= b, down to (gcd, 0) using the half-GCD for large
+// numbers, then Lehmer's steps and finally the binary GCD on single digits.
+inline void uinteger_t::_gcd(uinteger_t& a, uinteger_t& b, cofactors* co) {
+	uinteger_t c, d;
+	hgcd_matrix m;
+	while (b.size() >= gcd_hgcd_cutoff) {
+		if (_hgcd(a, b, m)) {
+			if (co) {
+				// the cofactors go through the same reduction
+				mult(co->tmp, m.m11, co->a);
+				addmul(co->tmp, m.m01, co->b);
+				mult(co->tmp2, m.m10, co->a);
+				addmul(co->tmp2, m.m00, co->b);
+				std::swap(co->a, co->tmp);
+				std::swap(co->b, co->tmp2);
+			}
+			if (compare(a, b) < 0) {
+				std::swap(a, b);
+				if (co) {
+					std::swap(co->a, co->b);
+					co->negative = !co->negative;
+				}
+			}
+		} else {
+			_euclid_step(a, b, c, d, co);
+		}
 	}
 
-	bool operator<=(const uinteger_t& rhs) const {
-		return compare(*this, rhs) <= 0;
+	while (!!b && a.size() > 1) {
+		if (!_lehmer_step(a, b, c, d, co)) {
+			_euclid_step(a, b, c, d, co);
+		}
 	}
 
-	// Arithmetic Operators
-	uinteger_t operator+(const uinteger_t& rhs) const {
-		return add(*this, rhs);
+	if (co) {
+		while (b) {
+			_euclid_step(a, b, c, d, co);
+		}
+	} else if (b) {
+		a = _gcd_1(a.front(), b.front());
+		b = uint_0();
 	}
+}
 
-	uinteger_t& operator+=(const uinteger_t& rhs) {
-		return add(*this, rhs);
-	}
+inline uinteger_t uinteger_t::gcd(const uinteger_t& a, const uinteger_t& b) {
+	auto swapped = compare(a, b) < 0;
+	uinteger_t x = swapped ? b : a;
+	uinteger_t y = swapped ? a : b;
+	_gcd(x, y, nullptr);
+	return x;
+}
 
-	uinteger_t operator-(const uinteger_t& rhs) const {
-		return sub(*this, rhs);
+inline uinteger_t uinteger_t::lcm(const uinteger_t& a, const uinteger_t& b) {
+	if (!a || !b) {
+		return uint_0();
 	}
+	return a / gcd(a, b) * b;
+}
 
-	uinteger_t& operator-=(const uinteger_t& rhs) {
-		return sub(*this, rhs);
+inline uinteger_t::bezout uinteger_t::gcdext(const uinteger_t& a, const uinteger_t& b) {
+	if (compare(a, b) < 0) {
+		auto result = gcdext(b, a);
+		std::swap(result.x, result.y);
+		result.x_negative = !result.x_negative;
+		return result;
 	}
 
-	uinteger_t operator*(const uinteger_t& rhs) const {
-		return mult(*this, rhs);
+	uinteger_t x = a;
+	uinteger_t y = b;
+	cofactors co;
+	co.a = uint_1();
+	co.negative = false;
+	_gcd(x, y, &co);
+
+	// y follows from a x + b y = gcd
+	bezout result;
+	result.gcd = std::move(x);
+	result.x = std::move(co.a);
+	result.x_negative = co.negative;
+	if (b) {
+		auto ax = a * result.x;
+		if (result.x_negative) {
+			result.y = (ax + result.gcd) / b;
+		} else {
+			result.y = (ax - result.gcd) / b;
+		}
 	}
+	return result;
+}
 
-	uinteger_t& operator*=(const uinteger_t& rhs) {
-		return mult(*this, rhs);
+inline uinteger_t uinteger_t::invmod(const uinteger_t& a, const uinteger_t& m) {
+	if (!m) {
+		throw std::domain_error("Error: division or modulus by 0");
 	}
-
-	std::pair<uinteger_t, uinteger_t> divmod(const uinteger_t& rhs) const {
-		return divmod(*this, rhs);
+	auto result = gcdext(a % m, m);
+	if (compare_1(result.gcd, 1) != 0) {
+		throw std::domain_error("Error: not invertible");
 	}
-
-	uinteger_t operator/(const uinteger_t& rhs) const {
-		return divmod(*this, rhs).first;
+	if (result.x_negative && !!result.x) {
+		return m - result.x;
 	}
+	return result.x % m;
+}
 
-	uinteger_t& operator/=(const uinteger_t& rhs) {
-		uinteger_t quotient;
-		uinteger_t remainder;
-		divmod(quotient, remainder, *this, rhs);
-		*this = std::move(quotient);
-		return *this;
-	}
+class uinteger_t::lazy_operand : public uinteger_t::lazy_node {
+public:
+	explicit lazy_operand(const uinteger_t& num) :
+		_num(num) { }
 
-	uinteger_t operator%(const uinteger_t& rhs) const {
-		return divmod(*this, rhs).second;
+	const uinteger_t& value() const {
+		return _num;
 	}
 
-	uinteger_t& operator%=(const uinteger_t& rhs) {
-		uinteger_t quotient;
-		uinteger_t remainder;
-		divmod(quotient, remainder, *this, rhs);
-		*this = std::move(remainder);
-		return *this;
+	bool refers_to(const uinteger_t& num) const {
+		return &_num._value == &num._value;
 	}
 
-	// Increment Operator
-	uinteger_t& operator++() {
-		return *this += uint_1();
-	}
-	uinteger_t operator++(int) {
-		uinteger_t temp(*this);
-		++*this;
-		return temp;
+	void assign_to(uinteger_t& result) const {
+		result = _num;
 	}
 
-	// Decrement Operator
-	uinteger_t& operator--() {
-		return *this -= uint_1();
-	}
-	uinteger_t operator--(int) {
-		uinteger_t temp(*this);
-		--*this;
-		return temp;
+	void add_to(uinteger_t& result) const {
+		add(result, _num);
 	}
 
-	// Nothing done since promotion doesn't work here
-	uinteger_t operator+() const {
-		return *this;
+	void sub_from(uinteger_t& result) const {
+		sub(result, _num);
 	}
 
-	// two's complement
-	uinteger_t operator-() const {
-		return uint_0() - *this;
-	}
+private:
+	const uinteger_t& _num;
+};
 
-	// Get private value at index
-	const digit& value(std::size_t idx) const {
-		static const digit zero = 0;
-		return idx < size() ? *(begin() + idx) : zero;
-	}
+// Op is one of '+', '-' or '*'
+template <typename Lhs, typename Rhs, char Op>
+class uinteger_t::lazy_expression : public uinteger_t::lazy_node {
+public:
+	lazy_expression(const Lhs& lhs, const Rhs& rhs) :
+		_lhs(lhs),
+		_rhs(rhs) { }
 
-	// Get value of bit N
-	bool operator[](std::size_t n) const {
-		auto nd = n / digit_bits;
-		auto nm = n % digit_bits;
-		return nd < size() ? (*(begin() + nd) >> nm) & 1 : 0;
+	uinteger_t value() const {
+		uinteger_t result;
+		assign_to(result);
+		return result;
 	}
 
-	// Get bitsize of value
-	std::size_t bits() const {
-		auto sz = size();
-		if (sz) {
-			return _bits(back()) + (sz - 1) * digit_bits;
-		}
-		return 0;
+	bool refers_to(const uinteger_t& num) const {
+		return _lhs.refers_to(num) || _rhs.refers_to(num);
 	}
 
-	// Get string representation of value
-	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
-	Result str(int alphabet_base = 10) const {
-		auto num_sz = size();
-		if (alphabet_base >= 2 && alphabet_base <= 36) {
-			Result result;
-			if (num_sz) {
-				auto alphabet_base_bits = base_bits(alphabet_base);
-				result.reserve(num_sz * base_size(alphabet_base));
-				if (alphabet_base_bits) {
-					digit alphabet_base_mask = alphabet_base - 1;
-					std::size_t shift = 0;
-					auto ptr = reinterpret_cast<const half_digit*>(data());
-					digit v = *ptr++;
-					v <<= half_digit_bits;
-					for (auto i = num_sz * 2 - 1; i; --i) {
-						v >>= half_digit_bits;
-						v |= (static_cast<digit>(*ptr++) << half_digit_bits);
-						do {
-							auto d = static_cast<int>((v >> shift) & alphabet_base_mask);
-							result.push_back(chr(d));
-							shift += alphabet_base_bits;
-						} while (shift <= half_digit_bits);
-						shift -= half_digit_bits;
-					}
-					v >>= (shift + half_digit_bits);
-					while (v) {
-						auto d = static_cast<int>(v & alphabet_base_mask);
-						result.push_back(chr(d));
-						v >>= alphabet_base_bits;
-					}
-					auto s = chr(0);
-					auto rit_f = std::find_if(result.rbegin(), result.rend(), [s](const char& c) { return c != s; });
-					result.resize(result.rend() - rit_f); // shrink
-				} else {
-					uinteger_t uint_base = alphabet_base;
-					uinteger_t quotient = *this;
-					do {
-						auto r = quotient.divmod(uint_base);
-						auto d = static_cast<int>(r.second);
-						result.push_back(chr(d));
-						quotient = std::move(r.first);
-					} while (quotient);
-				}
-				std::reverse(result.begin(), result.end());
+	void assign_to(uinteger_t& result) const {
+		if (Op == '*') {
+			const auto& lhs = _lhs.value();
+			const auto& rhs = _rhs.value();
+			if (std::min(lhs.size(), rhs.size()) < karatsuba_cutoff) {
+				// accumulated into the cleared result, reusing its storage
+				result.clear();
+				addmul(result, lhs, rhs);
 			} else {
-				result.push_back(chr(0));
+				mult(result, lhs, rhs);
 			}
-			return result;
-		} else if (alphabet_base == 256) {
-			if (num_sz) {
-				auto ptr = reinterpret_cast<const char*>(data());
-				Result result(ptr, ptr + num_sz * digit_octets);
-				auto rit_f = std::find_if(result.rbegin(), result.rend(), [](const char& c) { return c; });
-				result.resize(result.rend() - rit_f); // shrink
-				std::reverse(result.begin(), result.end());
-				return result;
+		} else {
+			_lhs.assign_to(result);
+			if (Op == '+') {
+				_rhs.add_to(result);
 			} else {
-				Result result;
-				result.push_back('\x00');
-				return result;
+				_rhs.sub_from(result);
 			}
-		} else {
-			throw std::invalid_argument("Base must be in the range [2, 36]");
 		}
 	}
 
-	static uinteger_t strtouint(const void* encoded, std::size_t encoded_size, int alphabet_base) {
-		const char* data = (const char *)encoded;
-		uinteger_t result;
-
-		if (alphabet_base >= 2 && alphabet_base <= 36) {
-			uinteger_t alphabet_base_bits = base_bits(alphabet_base);
-			uinteger_t uint_base = alphabet_base;
-			if (alphabet_base_bits) {
-				for (; encoded_size; --encoded_size, ++data) {
-					auto d = ord(static_cast<int>(*data));
-					if (d < 0) {
-						throw std::invalid_argument("Error: Not a digit in base " + std::to_string(alphabet_base) + ": '" + std::string(1, *data) + "' at " + std::to_string(encoded_size));
-					}
-					result = (result << alphabet_base_bits) | d;
-				}
-			} else {
-				for (; encoded_size; --encoded_size, ++data) {
-					auto d = ord(static_cast<int>(*data));
-					if (d < 0) {
-						throw std::invalid_argument("Error: Not a digit in base " + std::to_string(alphabet_base) + ": '" + std::string(1, *data) + "' at " + std::to_string(encoded_size));
-					}
-					result = (result * uint_base) + d;
-				}
-			}
-		} else if (encoded_size && alphabet_base == 256) {
-			auto value_size = encoded_size / digit_octets;
-			auto value_padding = encoded_size % digit_octets;
-			if (value_padding) {
-				value_padding = digit_octets - value_padding;
-				++value_size;
-			}
-			result.resize(value_size); // grow (no initialization)
-			*result.begin() = 0; // initialize value
-			auto ptr = reinterpret_cast<char*>(result.data());
-			std::copy(data, data + encoded_size, ptr + value_padding);
-			std::reverse(ptr, ptr + value_size * digit_octets);
+	void add_to(uinteger_t& result) const {
+		if (Op == '*') {
+			const auto& lhs = _lhs.value();
+			const auto& rhs = _rhs.value();
+			addmul(result, lhs, rhs);
+		} else if (Op == '+') {
+			_lhs.add_to(result);
+			_rhs.add_to(result);
 		} else {
-			throw std::invalid_argument("Error: Cannot convert from base " + std::to_string(alphabet_base));
+			// a difference is evaluated on its own first: subtracting its rhs
+			// from the running result could underflow where the eager
+			// operators would not
+			add(result, value());
 		}
-
-		return result;
 	}
 
-	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
-	Result bin() const {
-		return str<Result>(2);
+	void sub_from(uinteger_t& result) const {
+		if (Op == '*') {
+			const auto& lhs = _lhs.value();
+			const auto& rhs = _rhs.value();
+			submul(result, lhs, rhs);
+		} else {
+			// sums and differences are evaluated on their own first, so the
+			// result wraps around the same way it does with the eager operators
+			sub(result, value());
+		}
 	}
 
-	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
-	Result oct() const {
-		return str<Result>(8);
+private:
+	Lhs _lhs;
+	Rhs _rhs;
+};
+
+inline uinteger_t::lazy_operand uinteger_t::lazy(const uinteger_t& num) {
+	return lazy_operand(num);
+}
+
+template <typename Lhs, typename Rhs, char Op>
+uinteger_t::uinteger_t(const lazy_expression<Lhs, Rhs, Op>& expr) :
+	uinteger_t() {
+	expr.assign_to(*this);
+}
+
+template <typename Lhs, typename Rhs, char Op>
+uinteger_t& uinteger_t::operator=(const lazy_expression<Lhs, Rhs, Op>& expr) {
+	if (expr.refers_to(*this)) {
+		*this = expr.value();
+	} else {
+		expr.assign_to(*this);
 	}
+	return *this;
+}
 
-	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
-	Result hex() const {
-		return str<Result>(16);
+template <typename Lhs, typename Rhs, char Op>
+uinteger_t& uinteger_t::operator+=(const lazy_expression<Lhs, Rhs, Op>& expr) {
+	if (expr.refers_to(*this)) {
+		return add(*this, expr.value());
 	}
+	expr.add_to(*this);
+	return *this;
+}
 
-	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
-	Result raw() const {
-		return str<Result>(256);
+template <typename Lhs, typename Rhs, char Op>
+uinteger_t& uinteger_t::operator-=(const lazy_expression<Lhs, Rhs, Op>& expr) {
+	if (expr.refers_to(*this)) {
+		return sub(*this, expr.value());
 	}
-};
+	expr.sub_from(*this);
+	return *this;
+}
+
+// Lazy operators
+template <typename Lhs, typename Rhs, typename = uinteger_t::enable_if_lazy_t<Lhs, Rhs>>
+inline uinteger_t::lazy_expression<uinteger_t::lazy_t<Lhs>, uinteger_t::lazy_t<Rhs>, '+'> operator+(const Lhs& lhs, const Rhs& rhs) {
+	return {uinteger_t::lazy(lhs), uinteger_t::lazy(rhs)};
+}
+
+template <typename Lhs, typename Rhs, typename = uinteger_t::enable_if_lazy_t<Lhs, Rhs>>
+inline uinteger_t::lazy_expression<uinteger_t::lazy_t<Lhs>, uinteger_t::lazy_t<Rhs>, '-'> operator-(const Lhs& lhs, const Rhs& rhs) {
+	return {uinteger_t::lazy(lhs), uinteger_t::lazy(rhs)};
+}
+
+template <typename Lhs, typename Rhs, typename = uinteger_t::enable_if_lazy_t<Lhs, Rhs>>
+inline uinteger_t::lazy_expression<uinteger_t::lazy_t<Lhs>, uinteger_t::lazy_t<Rhs>, '*'> operator*(const Lhs& lhs, const Rhs& rhs) {
+	return {uinteger_t::lazy(lhs), uinteger_t::lazy(rhs)};
+}
 
 namespace std {  // This is probably not a good idea
 	// Make it work with std::string()
@@ -2400,7 +6205,12 @@ namespace std {  // This is probably not a good idea
 // Bitwise Operators
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator&(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) & rhs;
+	return rhs & lhs;
+}
+
+template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+uinteger_t operator&(const T& lhs, uinteger_t&& rhs) {
+	return std::move(rhs) & lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2410,7 +6220,12 @@ T& operator&=(T& lhs, const uinteger_t& rhs) {
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator|(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) | rhs;
+	return rhs | lhs;
+}
+
+template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+uinteger_t operator|(const T& lhs, uinteger_t&& rhs) {
+	return std::move(rhs) | lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2420,7 +6235,12 @@ T& operator|=(T& lhs, const uinteger_t& rhs) {
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator^(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) ^ rhs;
+	return rhs ^ lhs;
+}
+
+template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+uinteger_t operator^(const T& lhs, uinteger_t&& rhs) {
+	return std::move(rhs) ^ lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2431,7 +6251,10 @@ T& operator^=(T& lhs, const uinteger_t& rhs) {
 // Bitshift operators
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 inline uinteger_t operator<<(T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) << rhs;
+	// only the result is built, and shifted in place
+	uinteger_t result(lhs);
+	result <<= rhs;
+	return result;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2441,7 +6264,14 @@ T& operator<<=(T& lhs, const uinteger_t& rhs) {
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 inline uinteger_t operator>>(T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) >> rhs;
+	auto value = static_cast<uinteger_t::digit>(lhs);
+	if (!rhs) {
+		return value;
+	}
+	if (rhs.size() > 1 || rhs.front() >= uinteger_t::digit_bits) {
+		return 0;
+	}
+	return value >> rhs.front();
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2452,50 +6282,52 @@ T& operator>>=(T& lhs, const uinteger_t& rhs) {
 // Comparison Operators
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator==(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) == rhs;
+	return rhs == lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator!=(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) != rhs;
+	return rhs != lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator>(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) > rhs;
+	return rhs < lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator<(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) < rhs;
+	return rhs > lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator>=(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) >= rhs;
+	return rhs <= lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 bool operator<=(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) <= rhs;
+	return rhs >= lhs;
 }
 
 // Arithmetic Operators
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator+(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) + rhs;
+	return rhs + lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-T& operator+=(T& lhs, const uinteger_t& rhs) {
-	return lhs = static_cast<T>(rhs + lhs);
+uinteger_t operator+(const T& lhs, uinteger_t&& rhs) {
+	return std::move(rhs) + lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
-uinteger_t operator-(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) - rhs;
+T& operator+=(T& lhs, const uinteger_t& rhs) {
+	return lhs = static_cast<T>(rhs + lhs);
 }
 
+// operator-(T, uinteger_t) is defined in uinteger_t, as a friend
+
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 T& operator-=(T& lhs, const uinteger_t& rhs) {
 	return lhs = static_cast<T>(lhs - rhs);
@@ -2503,7 +6335,12 @@ T& operator-=(T& lhs, const uinteger_t& rhs) {
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator*(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) * rhs;
+	return rhs * lhs;
+}
+
+template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+uinteger_t operator*(const T& lhs, uinteger_t&& rhs) {
+	return std::move(rhs) * lhs;
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2511,9 +6348,15 @@ T& operator*=(T& lhs, const uinteger_t& rhs) {
 	return lhs = static_cast<T>(rhs * lhs);
 }
 
+// A native lhs is a single digit, so it's divided natively: by a larger rhs
+// the quotient is 0 and the remainder lhs.
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator/(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) / rhs;
+	if (!rhs) {
+		throw std::domain_error("Error: division or modulus by 0");
+	}
+	auto value = static_cast<uinteger_t::digit>(lhs);
+	return rhs.size() > 1 ? 0 : value / rhs.front();
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2523,7 +6366,11 @@ T& operator/=(T& lhs, const uinteger_t& rhs) {
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
 uinteger_t operator%(const T& lhs, const uinteger_t& rhs) {
-	return uinteger_t(lhs) % rhs;
+	if (!rhs) {
+		throw std::domain_error("Error: division or modulus by 0");
+	}
+	auto value = static_cast<uinteger_t::digit>(lhs);
+	return rhs.size() > 1 ? value : value % rhs.front();
 }
 
 template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
@@ -2532,6 +6379,14 @@ T& operator%=(T& lhs, const uinteger_t& rhs) {
 }
 
 // IO Operator
+inline uinteger_t::to_chars_result to_chars(char* first, char* last, const uinteger_t& value, int base = 10) {
+	return value.to_chars(first, last, base);
+}
+
+inline uinteger_t::from_chars_result from_chars(const char* first, const char* last, uinteger_t& value, int base = 10) {
+	return uinteger_t::from_chars(first, last, value, base);
+}
+
 inline std::ostream& operator<<(std::ostream& stream, const uinteger_t& rhs) {
 	if (stream.flags() & stream.oct) {
 		stream << rhs.str(8);
@@ -2543,4 +6398,448 @@ inline std::ostream& operator<<(std::ostream& stream, const uinteger_t& rhs) {
 	return stream;
 }
 
+
+// Fixed width unsigned integers
+// Stores exactly `Bits / digit_bits` digits inline (no allocation at all)
+// and wraps around modulo 2^Bits, like the native unsigned types do.
+// All loops are unrolled at compile time over the fixed number of digits.
+template <std::size_t Bits>
+class fixed_uinteger_t {
+public:
+	using digit = uinteger_t::digit;
+
+	static constexpr std::size_t digit_bits = uinteger_t::digit_bits;
+	static constexpr std::size_t digits = Bits / digit_bits;
+
+	static_assert(Bits && Bits % digit_bits == 0, "Bits must be a multiple of the digit size");
+
+private:
+	std::array<digit, digits> _value;
+
+	template <typename F, std::size_t... I>
+	static void _unroll(F&& f, std::index_sequence<I...>) {
+		using expand = int[];
+		(void)expand{0, ((void)f(std::integral_constant<std::size_t, I>()), 0)...};
+	}
+
+	template <std::size_t N, typename F>
+	static void _unroll(F&& f) {
+		_unroll(std::forward<F>(f), std::make_index_sequence<N>());
+	}
+
+	template <typename T>
+	static constexpr bool _negative(const T& value, std::true_type) {
+		return value < 0;
+	}
+
+	template <typename T>
+	static constexpr bool _negative(const T&, std::false_type) {
+		return false;
+	}
+
+	std::size_t _size() const noexcept {
+		auto sz = digits;
+		while (sz && !_value[sz - 1]) {
+			--sz;
+		}
+		return sz;
+	}
+
+public:
+	// Public Implementation
+	static fixed_uinteger_t& bitwise_and(fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		_unroll<digits>([&](auto i) { lhs._value[i] &= rhs._value[i]; });
+		return lhs;
+	}
+
+	static fixed_uinteger_t& bitwise_or(fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		_unroll<digits>([&](auto i) { lhs._value[i] |= rhs._value[i]; });
+		return lhs;
+	}
+
+	static fixed_uinteger_t& bitwise_xor(fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		_unroll<digits>([&](auto i) { lhs._value[i] ^= rhs._value[i]; });
+		return lhs;
+	}
+
+	static fixed_uinteger_t& bitwise_inv(fixed_uinteger_t& lhs) {
+		_unroll<digits>([&](auto i) { lhs._value[i] = ~lhs._value[i]; });
+		return lhs;
+	}
+
+	static fixed_uinteger_t& bitwise_lshift(fixed_uinteger_t& lhs, std::size_t rhs) {
+		if (rhs >= Bits) {
+			lhs._value.fill(0);
+			return lhs;
+		}
+		auto shifts = rhs / digit_bits;
+		auto shift = rhs % digit_bits;
+		for (auto i = digits; i-- > shifts;) {
+			auto v = lhs._value[i - shifts] << shift;
+			if (shift && i > shifts) {
+				v |= lhs._value[i - shifts - 1] >> (digit_bits - shift);
+			}
+			lhs._value[i] = v;
+		}
+		std::fill_n(lhs._value.begin(), shifts, 0);
+		return lhs;
+	}
+
+	static fixed_uinteger_t& bitwise_rshift(fixed_uinteger_t& lhs, std::size_t rhs) {
+		if (rhs >= Bits) {
+			lhs._value.fill(0);
+			return lhs;
+		}
+		auto shifts = rhs / digit_bits;
+		auto shift = rhs % digit_bits;
+		for (std::size_t i = 0; i < digits - shifts; ++i) {
+			auto v = lhs._value[i + shifts] >> shift;
+			if (shift && i + shifts + 1 < digits) {
+				v |= lhs._value[i + shifts + 1] << (digit_bits - shift);
+			}
+			lhs._value[i] = v;
+		}
+		std::fill_n(lhs._value.end() - shifts, shifts, 0);
+		return lhs;
+	}
+
+	static int compare(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		for (auto i = digits; i--;) {
+			if (lhs._value[i] != rhs._value[i]) {
+				return lhs._value[i] > rhs._value[i] ? 1 : -1;
+			}
+		}
+		return 0;
+	}
+
+	static fixed_uinteger_t& add(fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		digit carry = 0;
+		_unroll<digits>([&](auto i) {
+			carry = uinteger_t::_addcarry(lhs._value[i], rhs._value[i], carry, &lhs._value[i]);
+		});
+		return lhs;
+	}
+
+	static fixed_uinteger_t& sub(fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		digit borrow = 0;
+		_unroll<digits>([&](auto i) {
+			borrow = uinteger_t::_subborrow(lhs._value[i], rhs._value[i], borrow, &lhs._value[i]);
+		});
+		return lhs;
+	}
+
+	// Long multiplication, truncated to the lower `digits` digits
+	static fixed_uinteger_t mult(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		fixed_uinteger_t result;
+		_unroll<digits>([&](auto i) {
+			constexpr std::size_t I = decltype(i)::value;
+			auto n = lhs._value[I];
+			digit carry = 0;
+			_unroll<digits - I>([&](auto j) {
+				constexpr std::size_t K = I + decltype(j)::value;
+				carry = uinteger_t::_multadd(rhs._value[j], n, result._value[K], carry, &result._value[K]);
+			});
+		});
+		return result;
+	}
+
+	static std::pair<fixed_uinteger_t, fixed_uinteger_t> divmod(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		auto rhs_sz = rhs._size();
+		if (!rhs_sz) {
+			throw std::domain_error("Error: division or modulus by 0");
+		}
+		if (rhs_sz == 1) {
+			// Single word long division
+			auto n = rhs._value[0];
+			fixed_uinteger_t quotient;
+			digit r = 0;
+			for (auto i = lhs._size(); i--;) {
+				r = uinteger_t::_divmod(r, lhs._value[i], n, &quotient._value[i]);
+			}
+			return std::make_pair(quotient, fixed_uinteger_t(r));
+		}
+		if (compare(lhs, rhs) < 0) {
+			return std::make_pair(fixed_uinteger_t(), lhs);
+		}
+		auto r = uinteger_t::divmod(lhs.to_uinteger(), rhs.to_uinteger());
+		return std::make_pair(fixed_uinteger_t(r.first), fixed_uinteger_t(r.second));
+	}
+
+	// Constructors
+	fixed_uinteger_t() :
+		_value() { }
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	fixed_uinteger_t(const T& value) {
+		_value.fill(_negative(value, std::is_signed<T>()) ? ~static_cast<digit>(0) : 0);
+		_value[0] = static_cast<digit>(value);
+	}
+
+	explicit fixed_uinteger_t(const uinteger_t& o) :
+		_value() {
+		auto _digits = digits;
+		std::copy_n(o.begin(), std::min(o.size(), _digits), _value.begin());
+	}
+
+	template <std::size_t OtherBits>
+	explicit fixed_uinteger_t(const fixed_uinteger_t<OtherBits>& o) :
+		_value() {
+		auto _digits = digits;
+		std::copy_n(o.data(), std::min(o.size(), _digits), _value.begin());
+	}
+
+	template <typename T, std::size_t N>
+	explicit fixed_uinteger_t(T (&s)[N], int base=10) :
+		fixed_uinteger_t(uinteger_t(s, base)) { }
+
+	explicit fixed_uinteger_t(const std::string& bytes, int base=10) :
+		fixed_uinteger_t(uinteger_t(bytes, base)) { }
+
+	uinteger_t to_uinteger() const {
+		uinteger_t result;
+		auto sz = _size();
+		result.resize(sz);
+		std::copy_n(_value.begin(), sz, result.begin());
+		return result;
+	}
+
+	explicit operator uinteger_t() const {
+		return to_uinteger();
+	}
+
+	// Typecast Operators
+	explicit operator bool() const {
+		return static_cast<bool>(_size());
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value and not std::is_same<T, bool>::value and not std::is_same<T, std::decay_t<uinteger_t>>::value>>
+	explicit operator T() const {
+		return static_cast<T>(_value[0]);
+	}
+
+	// Bitwise Operators
+	friend fixed_uinteger_t operator&(fixed_uinteger_t lhs, const fixed_uinteger_t& rhs) {
+		return bitwise_and(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator&=(const fixed_uinteger_t& rhs) {
+		return bitwise_and(*this, rhs);
+	}
+
+	friend fixed_uinteger_t operator|(fixed_uinteger_t lhs, const fixed_uinteger_t& rhs) {
+		return bitwise_or(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator|=(const fixed_uinteger_t& rhs) {
+		return bitwise_or(*this, rhs);
+	}
+
+	friend fixed_uinteger_t operator^(fixed_uinteger_t lhs, const fixed_uinteger_t& rhs) {
+		return bitwise_xor(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator^=(const fixed_uinteger_t& rhs) {
+		return bitwise_xor(*this, rhs);
+	}
+
+	fixed_uinteger_t operator~() const {
+		fixed_uinteger_t result(*this);
+		return bitwise_inv(result);
+	}
+
+	// Bit Shift Operators
+	fixed_uinteger_t operator<<(std::size_t rhs) const {
+		fixed_uinteger_t result(*this);
+		return bitwise_lshift(result, rhs);
+	}
+
+	fixed_uinteger_t& operator<<=(std::size_t rhs) {
+		return bitwise_lshift(*this, rhs);
+	}
+
+	fixed_uinteger_t operator>>(std::size_t rhs) const {
+		fixed_uinteger_t result(*this);
+		return bitwise_rshift(result, rhs);
+	}
+
+	fixed_uinteger_t& operator>>=(std::size_t rhs) {
+		return bitwise_rshift(*this, rhs);
+	}
+
+	// Logical Operators
+	bool operator!() const {
+		return !static_cast<bool>(*this);
+	}
+
+	// Comparison Operators
+	friend bool operator==(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return lhs._value == rhs._value;
+	}
+
+	friend bool operator!=(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return lhs._value != rhs._value;
+	}
+
+	friend bool operator>(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return compare(lhs, rhs) > 0;
+	}
+
+	friend bool operator<(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return compare(lhs, rhs) < 0;
+	}
+
+	friend bool operator>=(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return compare(lhs, rhs) >= 0;
+	}
+
+	friend bool operator<=(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return compare(lhs, rhs) <= 0;
+	}
+
+	// Arithmetic Operators
+	friend fixed_uinteger_t operator+(fixed_uinteger_t lhs, const fixed_uinteger_t& rhs) {
+		return add(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator+=(const fixed_uinteger_t& rhs) {
+		return add(*this, rhs);
+	}
+
+	friend fixed_uinteger_t operator-(fixed_uinteger_t lhs, const fixed_uinteger_t& rhs) {
+		return sub(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator-=(const fixed_uinteger_t& rhs) {
+		return sub(*this, rhs);
+	}
+
+	friend fixed_uinteger_t operator*(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return mult(lhs, rhs);
+	}
+
+	fixed_uinteger_t& operator*=(const fixed_uinteger_t& rhs) {
+		return *this = mult(*this, rhs);
+	}
+
+	friend fixed_uinteger_t operator/(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return divmod(lhs, rhs).first;
+	}
+
+	fixed_uinteger_t& operator/=(const fixed_uinteger_t& rhs) {
+		return *this = divmod(*this, rhs).first;
+	}
+
+	friend fixed_uinteger_t operator%(const fixed_uinteger_t& lhs, const fixed_uinteger_t& rhs) {
+		return divmod(lhs, rhs).second;
+	}
+
+	fixed_uinteger_t& operator%=(const fixed_uinteger_t& rhs) {
+		return *this = divmod(*this, rhs).second;
+	}
+
+	// Increment Operator
+	fixed_uinteger_t& operator++() {
+		for (auto& v : _value) {
+			if (++v) {
+				break;
+			}
+		}
+		return *this;
+	}
+	fixed_uinteger_t operator++(int) {
+		fixed_uinteger_t temp(*this);
+		++*this;
+		return temp;
+	}
+
+	// Decrement Operator
+	fixed_uinteger_t& operator--() {
+		for (auto& v : _value) {
+			if (v--) {
+				break;
+			}
+		}
+		return *this;
+	}
+	fixed_uinteger_t operator--(int) {
+		fixed_uinteger_t temp(*this);
+		--*this;
+		return temp;
+	}
+
+	// Nothing done since promotion doesn't work here
+	fixed_uinteger_t operator+() const {
+		return *this;
+	}
+
+	// two's complement
+	fixed_uinteger_t operator-() const {
+		fixed_uinteger_t result(*this);
+		bitwise_inv(result);
+		return ++result;
+	}
+
+	// Get private value at index
+	const digit& value(std::size_t idx) const {
+		static const digit zero = 0;
+		return idx < digits ? _value[idx] : zero;
+	}
+
+	const digit* data() const noexcept {
+		return _value.data();
+	}
+
+	constexpr std::size_t size() const noexcept {
+		return digits;
+	}
+
+	// Get value of bit N
+	bool operator[](std::size_t n) const {
+		auto nd = n / digit_bits;
+		auto nm = n % digit_bits;
+		return nd < digits ? (_value[nd] >> nm) & 1 : 0;
+	}
+
+	// Get bitsize of value
+	std::size_t bits() const {
+		auto sz = _size();
+		if (sz) {
+			return uinteger_t::_bits(_value[sz - 1]) + (sz - 1) * digit_bits;
+		}
+		return 0;
+	}
+
+	// Get string representation of value
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result str(int alphabet_base = 10) const {
+		return to_uinteger().template str<Result>(alphabet_base);
+	}
+
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result bin() const {
+		return str<Result>(2);
+	}
+
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result oct() const {
+		return str<Result>(8);
+	}
+
+	template <typename Result = std::string, typename = std::enable_if_t<uinteger_t::is_result<Result>::value>>
+	Result hex() const {
+		return str<Result>(16);
+	}
+
+	// IO Operator
+	friend std::ostream& operator<<(std::ostream& stream, const fixed_uinteger_t& rhs) {
+		return stream << rhs.to_uinteger();
+	}
+};
+
+// Named after uinteger_t so they don't clash with other uint128_t types
+using uinteger128_t = fixed_uinteger_t<128>;
+using uinteger256_t = fixed_uinteger_t<256>;
+using uinteger512_t = fixed_uinteger_t<512>;
+using uinteger1024_t = fixed_uinteger_t<1024>;
+
 #endif